@@ -0,0 +1,52 @@
+// assetpacker.cpp
+// Genera el paquete de assets que proyecta el juego al arrancar (ver
+// AssetPack.h): todos los ficheros de los directorios indicados, con su ruta
+// relativa como nombre.
+//
+// Uso (desde ConsoleApplication3, para que las rutas queden relativas):
+//   AssetPacker [salida] [directorio...]
+// Por defecto empaqueta levels/ y textures/ en assets.pak.
+
+#include "AssetPack.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+int main(int argc, char** argv)
+{
+    const char* out = argc > 1 ? argv[1] : "assets.pak";
+    std::vector<std::string> dirs;
+    for (int i = 2; i < argc; ++i)
+        dirs.push_back(argv[i]);
+    if (dirs.empty())
+        dirs = { "levels", "textures" };
+
+    std::vector<std::string> files;
+    std::uintmax_t total = 0;
+    for (const std::string& dir : dirs) {
+        std::error_code ec;
+        for (fs::recursive_directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+            if (!it->is_regular_file())
+                continue;
+            files.push_back(it->path().generic_string());
+            total += it->file_size();
+            std::printf("%10ju  %s\n", it->file_size(), files.back().c_str());
+        }
+        if (ec)
+            std::fprintf(stderr, "No se pudo recorrer %s\n", dir.c_str());
+    }
+
+    if (files.empty()) {
+        std::fprintf(stderr, "No hay ficheros que empaquetar\n");
+        return 1;
+    }
+    if (!AssetPack_Write(out, files))
+        return 1;
+    std::printf("%zu ficheros, %ju bytes -> %s\n", files.size(), total, out);
+    return 0;
+}
@@ -0,0 +1,303 @@
+// assetpack.cpp
+// Formato .pak: PackHeader, PackEntry[entryCount] ordenadas por nombre, los
+// nombres seguidos (sin terminador) y, desde la siguiente frontera de
+// PACK_ALIGN, el contenido de cada entrada, también alineado. Alinear a
+// página hace que ninguna entrada comparta páginas con otra: leer o validar
+// una solo toca las suyas.
+
+#include "AssetPack.h"
+#include "Hash.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+static const std::uint32_t PACK_VERSION = 1;
+static const std::size_t PACK_ALIGN = 4096;
+
+struct PackHeader {
+    char          magic[4];       // "APAK"
+    std::uint32_t version;
+    std::uint32_t entryCount;
+    std::uint32_t namesSize;      // bytes de nombres tras las entradas
+    std::uint64_t tocHash;        // FNV-1a de entradas + nombres
+};
+
+struct PackEntry {
+    std::uint64_t offset;         // desde el inicio del paquete
+    std::uint64_t size;
+    std::uint64_t hash;           // FNV-1a del contenido
+    std::uint32_t nameOffset;     // dentro del bloque de nombres
+    std::uint32_t nameSize;
+};
+
+// Estado del checksum de cada entrada: se valida una vez, al primer uso
+enum : std::uint8_t { ENTRY_UNCHECKED, ENTRY_OK, ENTRY_CORRUPT };
+
+struct Pack {
+    MappedFile file;
+    std::int64_t time = 0;
+    const PackEntry* entries = nullptr;
+    const char* names = nullptr;
+    std::uint32_t count = 0;
+    std::unique_ptr<std::atomic<std::uint8_t>[]> state;
+};
+
+static Pack g_Pack;
+
+static std::size_t AlignUp(std::size_t n)
+{
+    return (n + PACK_ALIGN - 1) & ~(PACK_ALIGN - 1);
+}
+
+static std::int64_t FileTime(const char* path)
+{
+    std::error_code ec;
+    const auto time = fs::last_write_time(path, ec);
+    return ec ? 0 : (std::int64_t)time.time_since_epoch().count();
+}
+
+// Misma ruta escrita de otra forma: separador '/' y sin "./" delante
+static std::string NormalizeName(const char* name)
+{
+    std::string s = name;
+    std::replace(s.begin(), s.end(), '\\', '/');
+    while (s.compare(0, 2, "./") == 0)
+        s.erase(0, 2);
+    return s;
+}
+
+static std::string EntryName(const PackEntry& e)
+{
+    return std::string(g_Pack.names + e.nameOffset, e.nameSize);
+}
+
+// Índice de la entrada 'name' (búsqueda binaria), o -1
+static int FindEntry(const std::string& name)
+{
+    const PackEntry* first = g_Pack.entries;
+    const PackEntry* last = first + g_Pack.count;
+    const PackEntry* it = std::lower_bound(first, last, name,
+        [](const PackEntry& e, const std::string& n) {
+            return n.compare(0, n.size(), g_Pack.names + e.nameOffset, e.nameSize) > 0;
+        });
+    if (it == last || name.compare(0, name.size(), g_Pack.names + it->nameOffset, it->nameSize) != 0)
+        return -1;
+    return (int)(it - first);
+}
+
+// Entrada válida del paquete para 'name', o -1 si no está o está corrupta
+static int FindValidEntry(const std::string& name)
+{
+    if (!g_Pack.file.IsOpen())
+        return -1;
+    const int i = FindEntry(name);
+    if (i < 0)
+        return -1;
+
+    std::uint8_t s = g_Pack.state[i].load(std::memory_order_acquire);
+    if (s == ENTRY_UNCHECKED) {
+        // Dos hilos pueden validar la misma entrada a la vez: dan lo mismo
+        const PackEntry& e = g_Pack.entries[i];
+        const bool ok = Hash_Fnv1a64(g_Pack.file.Data() + e.offset, (std::size_t)e.size) == e.hash;
+        s = ok ? ENTRY_OK : ENTRY_CORRUPT;
+        if (g_Pack.state[i].exchange(s) == ENTRY_UNCHECKED && !ok)
+            std::cerr << "Entrada corrupta en el paquete de assets: " << name << std::endl;
+    }
+    return s == ENTRY_OK ? i : -1;
+}
+
+} // namespace
+
+bool AssetPack_Open(const char* path)
+{
+    Pack& p = g_Pack;
+    p.file.Close();
+    p.entries = nullptr;
+    p.names = nullptr;
+    p.count = 0;
+    p.state.reset();
+
+    if (!p.file.Open(path))
+        return false;
+
+    auto fail = [&](const char* why) {
+        std::cerr << "Paquete de assets no valido (" << why << "): " << path << std::endl;
+        p.file.Close();
+        return false;
+    };
+
+    const char* data = p.file.Data();
+    const std::size_t size = p.file.Size();
+    PackHeader h;
+    if (size < sizeof(h))
+        return fail("truncado");
+    std::memcpy(&h, data, sizeof(h));
+    if (std::memcmp(h.magic, "APAK", 4) != 0 || h.version != PACK_VERSION)
+        return fail("version");
+
+    const std::size_t tocSize = (std::size_t)h.entryCount * sizeof(PackEntry) + h.namesSize;
+    if (size - sizeof(h) < tocSize)
+        return fail("truncado");
+    if (Hash_Fnv1a64(data + sizeof(h), tocSize) != h.tocHash)
+        return fail("tabla");
+
+    // La cabecera mide 24 bytes: las entradas quedan alineadas a 8
+    p.entries = reinterpret_cast<const PackEntry*>(data + sizeof(h));
+    p.names = data + sizeof(h) + (std::size_t)h.entryCount * sizeof(PackEntry);
+    p.count = h.entryCount;
+    for (std::uint32_t i = 0; i < p.count; ++i) {
+        const PackEntry& e = p.entries[i];
+        if ((std::uint64_t)e.nameOffset + e.nameSize > h.namesSize)
+            return fail("nombres");
+        if (e.offset % PACK_ALIGN != 0 || e.offset > size || e.size > size - e.offset)
+            return fail("entradas");
+        if (i > 0 && EntryName(p.entries[i - 1]) >= EntryName(e))
+            return fail("orden");
+    }
+
+    p.time = FileTime(path);
+    p.state.reset(new std::atomic<std::uint8_t>[p.count]);
+    for (std::uint32_t i = 0; i < p.count; ++i)
+        p.state[i].store(ENTRY_UNCHECKED, std::memory_order_relaxed);
+    return true;
+}
+
+bool AssetPack_Write(const char* path, const std::vector<std::string>& files)
+{
+    // Nombres ordenados para la búsqueda binaria; cada fichero se proyecta
+    // para escribirlo sin copiarlo
+    std::vector<std::string> names;
+    for (const std::string& f : files)
+        names.push_back(NormalizeName(f.c_str()));
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+
+    std::vector<MappedFile> sources(names.size());
+    std::vector<PackEntry> entries(names.size());
+    std::string nameBlock;
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        if (!sources[i].Open(names[i].c_str())) {
+            std::cerr << "No se pudo leer " << names[i] << std::endl;
+            return false;
+        }
+        entries[i].size = sources[i].Size();
+        entries[i].hash = Hash_Fnv1a64(sources[i].Data(), sources[i].Size());
+        entries[i].nameOffset = (std::uint32_t)nameBlock.size();
+        entries[i].nameSize = (std::uint32_t)names[i].size();
+        nameBlock += names[i];
+    }
+
+    PackHeader h = {};
+    std::memcpy(h.magic, "APAK", 4);
+    h.version = PACK_VERSION;
+    h.entryCount = (std::uint32_t)entries.size();
+    h.namesSize = (std::uint32_t)nameBlock.size();
+
+    std::size_t offset = sizeof(h) + entries.size() * sizeof(PackEntry) + nameBlock.size();
+    for (PackEntry& e : entries) {
+        e.offset = AlignUp(offset);
+        offset = (std::size_t)(e.offset + e.size);
+    }
+    h.tocHash = Hash_Fnv1a64(entries.data(), entries.size() * sizeof(PackEntry));
+    h.tocHash = Hash_Fnv1a64(nameBlock.data(), nameBlock.size(), h.tocHash);
+
+    const std::string tmp = std::string(path) + ".tmp";
+    FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) {
+        std::cerr << "No se pudo escribir " << tmp << std::endl;
+        return false;
+    }
+
+    static const char zeros[PACK_ALIGN] = {};
+    std::fwrite(&h, sizeof(h), 1, f);
+    std::fwrite(entries.data(), sizeof(PackEntry), entries.size(), f);
+    std::fwrite(nameBlock.data(), 1, nameBlock.size(), f);
+    offset = sizeof(h) + entries.size() * sizeof(PackEntry) + nameBlock.size();
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        std::fwrite(zeros, 1, (std::size_t)entries[i].offset - offset, f);
+        std::fwrite(sources[i].Data(), 1, sources[i].Size(), f);
+        offset = (std::size_t)(entries[i].offset + entries[i].size);
+    }
+
+    std::error_code ec;
+    const bool ok = !std::ferror(f);
+    if (std::fclose(f) != 0 || !ok) {
+        std::cerr << "No se pudo escribir " << tmp << std::endl;
+        fs::remove(tmp, ec);
+        return false;
+    }
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        std::cerr << "No se pudo escribir " << path << std::endl;
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+bool Asset_Open(const char* name, AssetData& out)
+{
+    out = AssetData();
+    const std::string n = NormalizeName(name);
+    const int i = FindValidEntry(n);
+    if (i >= 0) {
+        const PackEntry& e = g_Pack.entries[i];
+        out.data = g_Pack.file.Data() + e.offset;
+        out.size = (std::size_t)e.size;
+        return true;
+    }
+
+    auto file = std::make_shared<MappedFile>();
+    if (!file->Open(n.c_str()))
+        return false;
+    out.data = file->Data();
+    out.size = file->Size();
+    out.file = std::move(file);
+    return true;
+}
+
+bool Asset_Info(const char* name, AssetInfo& out)
+{
+    out = AssetInfo();
+    const std::string n = NormalizeName(name);
+    const int i = FindValidEntry(n);
+    if (i >= 0) {
+        out.size = g_Pack.entries[i].size;
+        out.time = g_Pack.time;
+        out.hash = g_Pack.entries[i].hash;
+        out.hashKnown = true;
+        return true;
+    }
+
+    std::error_code ec;
+    const auto size = fs::file_size(n, ec);
+    if (ec) return false;
+    const auto time = fs::last_write_time(n, ec);
+    if (ec) return false;
+    out.size = (std::uint64_t)size;
+    out.time = (std::int64_t)time.time_since_epoch().count();
+    return true;
+}
+
+bool Asset_Hash(const char* name, std::uint64_t& out)
+{
+    AssetInfo info;
+    if (Asset_Info(name, info) && info.hashKnown) {
+        out = info.hash;
+        return true;
+    }
+    AssetData data;
+    if (!Asset_Open(name, data))
+        return false;
+    out = Hash_Fnv1a64(data.data, data.size);
+    return true;
+}
@@ -0,0 +1,51 @@
+// assetpack.h
+// Paquete de assets: un único fichero (assets.pak, lo genera AssetPacker) con
+// tabla de contenidos y los ficheros de levels/ y textures/ alineados a
+// página, proyectado en memoria al arrancar. Los cargadores piden cada asset
+// por su ruta relativa y leen directamente de la proyección, sin copias. Lo
+// que no esté en el paquete (o si no hay paquete) se proyecta suelto desde
+// disco, así que durante el desarrollo se puede seguir editando a mano.
+
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Bytes de un asset. Los del paquete valen mientras siga abierto (toda la
+// ejecución); los de un fichero suelto, mientras viva 'file'.
+struct AssetData {
+    const char* data = nullptr;
+    std::size_t size = 0;
+    std::shared_ptr<const MappedFile> file;   // solo ficheros sueltos
+};
+
+// Identidad del contenido para cachés derivadas (ver TextureDiskCache)
+struct AssetInfo {
+    std::uint64_t size = 0;
+    std::int64_t  time = 0;        // fecha del fichero suelto o del paquete
+    std::uint64_t hash = 0;        // FNV-1a del contenido si hashKnown
+    bool          hashKnown = false;   // del paquete: sale de la tabla
+};
+
+// Proyecta el paquete y valida cabecera y tabla. El checksum de cada entrada
+// se comprueba la primera vez que se pide; una entrada corrupta se descarta
+// con aviso y se busca suelta. Que no exista el paquete no es error (devuelve
+// false sin avisar). Llamar al arrancar, antes de World_Init().
+bool AssetPack_Open(const char* path);
+
+// Escribe un paquete con 'files' (rutas relativas al directorio de trabajo,
+// que pasan a ser los nombres de las entradas). A un temporal y renombrado.
+bool AssetPack_Write(const char* path, const std::vector<std::string>& files);
+
+// Asset por ruta relativa ("textures/panorama.jpg"): del paquete o suelto.
+// Desde cualquier hilo.
+bool Asset_Open(const char* name, AssetData& out);
+bool Asset_Info(const char* name, AssetInfo& out);
+
+// FNV-1a del contenido: del paquete sin leerlo; suelto, proyectándolo
+bool Asset_Hash(const char* name, std::uint64_t& out);
@@ -0,0 +1,178 @@
+// bitgrid.h
+// Rejilla de un bit por celda (1 = muro) en filas de palabras de 64 bits,
+// con operaciones por palabra: tramos seguidos de una fila, máscaras de
+// vecinos y recuento de muros. Las operaciones de fila son constexpr (sin
+// intrínsecos) para poder usarlas también al hornear en compilación.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Bits de una palabra
+// -----------------------------------------------------------------------------
+
+inline constexpr unsigned char BITS_DEBRUIJN_INDEX[64] = {
+    0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+    62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+    63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+    46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6,
+};
+
+// Índice del bit más bajo a 1 (v != 0)
+constexpr int Bits_LowestSet(std::uint64_t v)
+{
+    return BITS_DEBRUIJN_INDEX[((v & (0 - v)) * 0x03F79D71B4CB0A89ull) >> 58];
+}
+
+constexpr int Bits_PopCount(std::uint64_t v)
+{
+    v = v - ((v >> 1) & 0x5555555555555555ull);
+    v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (int)((v * 0x0101010101010101ull) >> 56);
+}
+
+// Bits [x, x + n) de una palabra, con 0 <= x < 64 y x + n <= 64
+constexpr std::uint64_t Bits_Range(int x, int n)
+{
+    return (n >= 64 ? ~0ull : ((1ull << n) - 1)) << x;
+}
+
+// -----------------------------------------------------------------------------
+// Filas de bits. Los bits de relleno tras 'width' deben estar a 0.
+// -----------------------------------------------------------------------------
+
+// Primera celda muro en [x, width), o width si no hay
+constexpr int BitRow_NextSet(const std::uint64_t* row, int x, int width)
+{
+    if (x >= width) return width;
+    int k = x >> 6;
+    std::uint64_t bits = row[k] & (~0ull << (x & 63));
+    const int words = (width + 63) >> 6;
+    while (!bits) {
+        if (++k == words) return width;
+        bits = row[k];
+    }
+    const int found = (k << 6) + Bits_LowestSet(bits);
+    return found < width ? found : width;
+}
+
+// Primera celda libre en [x, width), o width si no hay
+constexpr int BitRow_NextClear(const std::uint64_t* row, int x, int width)
+{
+    if (x >= width) return width;
+    int k = x >> 6;
+    std::uint64_t bits = ~row[k] & (~0ull << (x & 63));
+    const int words = (width + 63) >> 6;
+    while (!bits) {
+        if (++k == words) return width;
+        bits = ~row[k];
+    }
+    const int found = (k << 6) + Bits_LowestSet(bits);
+    return found < width ? found : width;
+}
+
+// ¿Son muro todas las celdas [x, x + n)?
+constexpr bool BitRow_AllSet(const std::uint64_t* row, int x, int n)
+{
+    while (n > 0) {
+        const int b = x & 63;
+        const int take = n < 64 - b ? n : 64 - b;
+        const std::uint64_t mask = Bits_Range(b, take);
+        if ((row[x >> 6] & mask) != mask) return false;
+        x += take;
+        n -= take;
+    }
+    return true;
+}
+
+constexpr void BitRow_ClearRange(std::uint64_t* row, int x, int n)
+{
+    while (n > 0) {
+        const int b = x & 63;
+        const int take = n < 64 - b ? n : 64 - b;
+        row[x >> 6] &= ~Bits_Range(b, take);
+        x += take;
+        n -= take;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// BitGrid
+// -----------------------------------------------------------------------------
+class BitGrid {
+public:
+    BitGrid() = default;
+    BitGrid(int width, int height, bool value = false) { Resize(width, height, value); }
+
+    void Resize(int width, int height, bool value = false)
+    {
+        m_Width = width;
+        m_Height = height;
+        m_RowWords = (width + 63) >> 6;
+        m_Words.assign((size_t)m_RowWords * height, value ? ~0ull : 0ull);
+        if (value && (width & 63)) {
+            const std::uint64_t tail = Bits_Range(0, width & 63);
+            for (int z = 0; z < height; ++z)
+                Row(z)[m_RowWords - 1] = tail;
+        }
+    }
+
+    int Width() const { return m_Width; }
+    int Height() const { return m_Height; }
+    int RowWords() const { return m_RowWords; }
+
+    std::uint64_t* Row(int z) { return m_Words.data() + (size_t)z * m_RowWords; }
+    const std::uint64_t* Row(int z) const { return m_Words.data() + (size_t)z * m_RowWords; }
+    const std::vector<std::uint64_t>& Words() const { return m_Words; }
+
+    // Celda dentro de la rejilla
+    bool Get(int x, int z) const { return (Row(z)[x >> 6] >> (x & 63)) & 1; }
+
+    // Fuera de la rejilla cuenta como libre
+    bool Test(int x, int z) const
+    {
+        return x >= 0 && z >= 0 && x < m_Width && z < m_Height && Get(x, z);
+    }
+
+    void Set(int x, int z, bool value)
+    {
+        std::uint64_t& w = Row(z)[x >> 6];
+        const std::uint64_t bit = 1ull << (x & 63);
+        w = value ? (w | bit) : (w & ~bit);
+    }
+
+    // Bits de Test(64 * k + i + dx, z) para i = 0..63, con dx en [-63, 63].
+    // Alinea la fila con sus vecinas para evaluar 64 celdas a la vez.
+    std::uint64_t Neighbours(int z, int k, int dx) const
+    {
+        if (z < 0 || z >= m_Height) return 0;
+        const std::uint64_t* row = Row(z);
+        auto word = [&](int i) { return i >= 0 && i < m_RowWords ? row[i] : 0ull; };
+        if (dx == 0) return word(k);
+        if (dx > 0) return (word(k) >> dx) | (word(k + 1) << (64 - dx));
+        return (word(k) << -dx) | (word(k - 1) >> (64 + dx));
+    }
+
+    // Celdas muro
+    size_t Count() const
+    {
+        size_t n = 0;
+        for (std::uint64_t w : m_Words) n += Bits_PopCount(w);
+        return n;
+    }
+
+    bool operator==(const BitGrid& o) const
+    {
+        return m_Width == o.m_Width && m_Height == o.m_Height && m_Words == o.m_Words;
+    }
+
+private:
+    int m_Width = 0;
+    int m_Height = 0;
+    int m_RowWords = 0;
+    std::vector<std::uint64_t> m_Words;
+};
@@ -0,0 +1,23 @@
+// hash.h
+// FNV-1a de 64 bits: claves y comprobación de ficheros de caché.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+static const std::uint64_t HASH_FNV_OFFSET = 0xcbf29ce484222325ull;
+static const std::uint64_t HASH_FNV_PRIME = 0x100000001b3ull;
+
+// 'seed' permite encadenar: Hash_Fnv1a64(b, nb, Hash_Fnv1a64(a, na))
+inline std::uint64_t Hash_Fnv1a64(const void* data, std::size_t size,
+    std::uint64_t seed = HASH_FNV_OFFSET)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    std::uint64_t h = seed;
+    for (std::size_t i = 0; i < size; ++i) {
+        h ^= p[i];
+        h *= HASH_FNV_PRIME;
+    }
+    return h;
+}
@@ -0,0 +1,197 @@
+// levelfile.cpp
+// Carga de niveles desde fichero de texto proyectado en memoria.
+//
+// Sintaxis (una directiva por línea, '#' inicia comentario):
+//
+//   size   <ancho> <alto>          obligatorio, antes de 'grid'
+//   wall   <ruta textura muros>
+//   sky    <ruta panorama equirect>
+//   spawn  <x> <z>                 en celdas, admite decimales y negativos
+//   prism  <columna> <fila>        una línea por prisma, en orden
+//   grid                           seguido de <alto> filas de <ancho> '0'/'1'
+//   generate <semilla> <prismas>   alternativa a 'grid': laberinto procedural
+//                                  de tamaño 'size' (ver MazeGen.h)
+//
+// La rejilla va siempre al final del fichero. Con 'generate' no hay rejilla
+// y las líneas 'prism' se ignoran: los prismas salen del camino solución.
+
+#include "LevelFile.h"
+#include "AssetPack.h"
+#include "MazeGen.h"
+
+#include <charconv>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+struct Cursor {
+    const char* p;
+    const char* end;
+    int line;
+};
+
+static inline bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+static void SkipSpaces(Cursor& c)
+{
+    while (c.p < c.end && IsSpace(*c.p)) ++c.p;
+}
+
+// Avanza hasta el inicio de la siguiente línea
+static void NextLine(Cursor& c)
+{
+    while (c.p < c.end && *c.p != '\n') ++c.p;
+    if (c.p < c.end) ++c.p;
+    ++c.line;
+}
+
+static bool AtLineEnd(Cursor& c)
+{
+    SkipSpaces(c);
+    return c.p >= c.end || *c.p == '\n' || *c.p == '#';
+}
+
+// Lee una palabra; devuelve puntero al texto proyectado (sin copiar)
+static const char* ReadToken(Cursor& c, std::size_t& len)
+{
+    SkipSpaces(c);
+    const char* start = c.p;
+    while (c.p < c.end && !IsSpace(*c.p) && *c.p != '\n' && *c.p != '#') ++c.p;
+    len = (std::size_t)(c.p - start);
+    return start;
+}
+
+template <typename T>
+static bool ReadNumber(Cursor& c, T& value)
+{
+    SkipSpaces(c);
+    auto res = std::from_chars(c.p, c.end, value);
+    if (res.ec != std::errc()) return false;
+    c.p = res.ptr;
+    return true;
+}
+
+static inline bool TokenIs(const char* tok, std::size_t len, const char* word)
+{
+    return std::strlen(word) == len && std::memcmp(tok, word, len) == 0;
+}
+
+static bool Fail(const Cursor& c, const char* msg)
+{
+    std::cerr << "Error en nivel (linea " << c.line << "): " << msg << std::endl;
+    return false;
+}
+
+} // namespace
+
+bool LevelFile_Parse(const char* data, std::size_t size, LevelData& out)
+{
+    out = LevelData();
+    Cursor c{ data, data + size, 1 };
+    bool gridDone = false;
+    bool generate = false;
+    MazeGenParams gen;
+
+    while (c.p < c.end && !gridDone) {
+        if (AtLineEnd(c)) {
+            NextLine(c);
+            continue;
+        }
+
+        std::size_t len = 0;
+        const char* key = ReadToken(c, len);
+
+        if (TokenIs(key, len, "size")) {
+            if (!ReadNumber(c, out.width) || !ReadNumber(c, out.height) ||
+                out.width <= 0 || out.height <= 0)
+                return Fail(c, "'size' necesita ancho y alto positivos");
+        }
+        else if (TokenIs(key, len, "wall") || TokenIs(key, len, "sky")) {
+            std::size_t pathLen = 0;
+            const char* path = ReadToken(c, pathLen);
+            if (pathLen == 0)
+                return Fail(c, "falta la ruta de la textura");
+            (key[0] == 'w' ? out.wallTexture : out.skyTexture).assign(path, pathLen);
+        }
+        else if (TokenIs(key, len, "spawn")) {
+            if (!ReadNumber(c, out.spawnX) || !ReadNumber(c, out.spawnZ))
+                return Fail(c, "'spawn' necesita x y z");
+            out.hasSpawn = true;
+        }
+        else if (TokenIs(key, len, "prism")) {
+            CellCoord cell;
+            if (!ReadNumber(c, cell.x) || !ReadNumber(c, cell.z))
+                return Fail(c, "'prism' necesita columna y fila");
+            out.prisms.push_back(cell);
+        }
+        else if (TokenIs(key, len, "generate")) {
+            if (!ReadNumber(c, gen.seed) || !ReadNumber(c, gen.numPrisms) || gen.numPrisms < 0)
+                return Fail(c, "'generate' necesita semilla y numero de prismas");
+            generate = true;
+        }
+        else if (TokenIs(key, len, "grid")) {
+            if (out.width <= 0)
+                return Fail(c, "'grid' antes de 'size'");
+            if (generate)
+                return Fail(c, "'grid' y 'generate' son incompatibles");
+            if (!AtLineEnd(c))
+                return Fail(c, "texto inesperado tras 'grid'");
+            NextLine(c);
+
+            const std::size_t w = (std::size_t)out.width;
+            out.grid.Resize(out.width, out.height);
+
+            for (int z = 0; z < out.height; ++z) {
+                if ((std::size_t)(c.end - c.p) < w)
+                    return Fail(c, "faltan filas en 'grid'");
+                std::uint64_t* dst = out.grid.Row(z);
+                for (std::size_t x = 0; x < w; ++x) {
+                    unsigned v = (unsigned)(c.p[x] - '0');
+                    if (v > 1)
+                        return Fail(c, "celda no valida (solo '0' o '1')");
+                    dst[x >> 6] |= (std::uint64_t)v << (x & 63);
+                }
+                c.p += w;
+                if (!AtLineEnd(c))
+                    return Fail(c, "fila mas larga que el ancho declarado");
+                NextLine(c);
+            }
+            gridDone = true;
+            continue;
+        }
+        else {
+            return Fail(c, "directiva desconocida");
+        }
+
+        if (!AtLineEnd(c))
+            return Fail(c, "texto inesperado al final de la linea");
+        NextLine(c);
+    }
+
+    if (generate) {
+        if (out.width <= 0)
+            return Fail(c, "'generate' necesita 'size'");
+        gen.width = out.width;
+        gen.height = out.height;
+        if (!MazeGen_Generate(gen, out))
+            return Fail(c, "no se pudo generar el laberinto");
+    }
+    else if (!gridDone) {
+        return Fail(c, "falta la seccion 'grid'");
+    }
+
+    for (const CellCoord& p : out.prisms) {
+        if (p.x < 0 || p.x >= out.width || p.z < 0 || p.z >= out.height)
+            return Fail(c, "prisma fuera del laberinto");
+    }
+    return true;
+}
+
+bool LevelFile_Load(const char* path, LevelData& out)
+{
+    AssetData asset;
+    if (!Asset_Open(path, asset))
+        return false;
+    return LevelFile_Parse(asset.data, asset.size, out);
+}
@@ -0,0 +1,39 @@
+// levelfile.h
+// Formato de fichero de nivel (.lvl): rejilla del laberinto, prismas,
+// texturas y spawn. Ver LevelFile.cpp para la sintaxis.
+
+#pragma once
+
+#include "BitGrid.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct CellCoord {
+    int x; // columna
+    int z; // fila
+};
+
+struct LevelData {
+    int width = 0;
+    int height = 0;
+    BitGrid grid;                     // bit a 1 = muro; grid.Get(x, z)
+    std::vector<CellCoord> prisms;    // prismas (triggers de puzzles)
+    std::string wallTexture;
+    std::string skyTexture;
+
+    // Spawn en unidades de celda (mundo = valor * CELL). Si no viene en el
+    // fichero el mundo usa su posición por defecto dentro del foyer.
+    bool  hasSpawn = false;
+    float spawnX = 0.0f;
+    float spawnZ = 0.0f;
+};
+
+// Parsea un nivel desde memoria (p. ej. un fichero proyectado). No copia el
+// texto de entrada: la rejilla se escribe directamente en out.grid.
+bool LevelFile_Parse(const char* data, std::size_t size, LevelData& out);
+
+// Parsea el asset 'path' desde el paquete o el fichero suelto proyectado
+// (ver AssetPack.h).
+bool LevelFile_Load(const char* path, LevelData& out);
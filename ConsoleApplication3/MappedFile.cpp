@@ -0,0 +1,91 @@
+// mappedfile.cpp
+// Proyección de ficheros en memoria para los cargadores de assets.
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::Open(const char* path)
+{
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_File = file;
+    m_Mapping = mapping;
+    m_Data = static_cast<const char*>(view);
+    m_Size = (std::size_t)size.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);   // la proyección sigue siendo válida sin el descriptor
+    if (view == MAP_FAILED)
+        return false;
+
+    m_Data = static_cast<const char*>(view);
+    m_Size = (std::size_t)st.st_size;
+#endif
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (!m_Data)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_Data);
+    CloseHandle((HANDLE)m_Mapping);
+    CloseHandle((HANDLE)m_File);
+    m_File = m_Mapping = nullptr;
+#else
+    munmap((void*)m_Data, m_Size);
+#endif
+    m_Data = nullptr;
+    m_Size = 0;
+}
@@ -0,0 +1,32 @@
+// mappedfile.h
+// Fichero de solo lectura proyectado en memoria (Win32 / POSIX).
+
+#pragma once
+
+#include <cstddef>
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Abre y proyecta el fichero completo. Devuelve false si no existe,
+    // está vacío o no se puede proyectar.
+    bool Open(const char* path);
+    void Close();
+
+    const char* Data() const { return m_Data; }
+    std::size_t Size() const { return m_Size; }
+    bool IsOpen() const { return m_Data != nullptr; }
+
+private:
+    const char* m_Data = nullptr;
+    std::size_t m_Size = 0;
+#ifdef _WIN32
+    void* m_File = nullptr;      // HANDLE
+    void* m_Mapping = nullptr;   // HANDLE
+#endif
+};
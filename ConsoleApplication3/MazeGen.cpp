@@ -0,0 +1,137 @@
+// mazegen.cpp
+// Recursive backtracker iterativo sobre una rejilla de bytes + BFS para el
+// camino solución. Sin recursión: funciona igual con millones de celdas.
+
+#include "MazeGen.h"
+#include "LevelFile.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Abre el paso vertical en la columna 'x' desde la fila 'z' (borde) hacia
+// dentro hasta tocar un pasillo ya tallado.
+static void CarveDoor(std::vector<std::uint8_t>& g, int w, int h, int x, int z, int dz)
+{
+    for (; z >= 0 && z < h; z += dz) {
+        std::uint8_t& c = g[(size_t)z * w + x];
+        if (c == 0) return;
+        c = 0;
+        bool left = x > 0 && g[(size_t)z * w + x - 1] == 0;
+        bool right = x + 1 < w && g[(size_t)z * w + x + 1] == 0;
+        if (left || right) return;
+    }
+}
+
+} // namespace
+
+bool MazeGen_Generate(const MazeGenParams& params, LevelData& out)
+{
+    const int w = params.width;
+    const int h = params.height;
+    if (w < 3 || h < 3)
+        return false;
+
+    // 1 = muro. Las celdas del retículo están en coordenadas impares;
+    // si el tamaño es par la última fila/columna queda como muro macizo.
+    std::vector<std::uint8_t> g((size_t)w * h, 1);
+    const int cw = (w - 1) / 2;
+    const int ch = (h - 1) / 2;
+
+    std::mt19937 rng(params.seed);
+
+    // --- Recursive backtracker con pila explícita (índices del retículo) ---
+    std::vector<int> stack;
+    stack.reserve((size_t)cw * ch / 4 + 16);
+
+    auto gridIndex = [&](int cx, int cz) { return (size_t)(2 * cz + 1) * w + (2 * cx + 1); };
+
+    const int startX = std::min((w / 2) / 2, cw - 1);
+    stack.push_back(startX);
+    g[gridIndex(startX, 0)] = 0;
+
+    static const int DX[4] = { 1, -1, 0, 0 };
+    static const int DZ[4] = { 0, 0, 1, -1 };
+
+    while (!stack.empty()) {
+        const int cur = stack.back();
+        const int cx = cur % cw;
+        const int cz = cur / cw;
+
+        int options[4];
+        int n = 0;
+        for (int d = 0; d < 4; ++d) {
+            int nx = cx + DX[d], nz = cz + DZ[d];
+            if (nx < 0 || nz < 0 || nx >= cw || nz >= ch) continue;
+            if (g[gridIndex(nx, nz)] == 0) continue;
+            options[n++] = d;
+        }
+
+        if (n == 0) {
+            stack.pop_back();
+            continue;
+        }
+
+        const int d = options[rng() % (unsigned)n];
+        const int nx = cx + DX[d], nz = cz + DZ[d];
+        g[(size_t)(2 * cz + 1 + DZ[d]) * w + (2 * cx + 1 + DX[d])] = 0;   // muro intermedio
+        g[gridIndex(nx, nz)] = 0;
+        stack.push_back(nz * cw + nx);
+    }
+
+    // --- Entrada y salida en la columna central ---
+    const int door = w / 2;
+    CarveDoor(g, w, h, door, 0, +1);
+    CarveDoor(g, w, h, door, h - 1, -1);
+
+    // --- Camino solución (BFS) para colocar los prismas ---
+    const int start = door;                          // (door, 0)
+    const int goal = (h - 1) * w + door;             // (door, h - 1)
+    std::vector<int> parent((size_t)w * h, -1);
+    std::vector<int> queue;
+    queue.reserve((size_t)cw * ch);
+    queue.push_back(start);
+    parent[start] = start;
+
+    for (size_t head = 0; head < queue.size() && parent[goal] < 0; ++head) {
+        const int cur = queue[head];
+        const int x = cur % w, z = cur / w;
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + DX[d], nz = z + DZ[d];
+            if (nx < 0 || nz < 0 || nx >= w || nz >= h) continue;
+            int ni = nz * w + nx;
+            if (g[ni] != 0 || parent[ni] >= 0) continue;
+            parent[ni] = cur;
+            queue.push_back(ni);
+        }
+    }
+    if (parent[goal] < 0)
+        return false;
+
+    std::vector<int> path;
+    for (int i = goal; i != start; i = parent[i])
+        path.push_back(i);
+    path.push_back(start);
+
+    // --- Volcar al formato de nivel ---
+    out.width = w;
+    out.height = h;
+    out.grid.Resize(w, h);
+    for (int z = 0; z < h; ++z) {
+        const std::uint8_t* src = &g[(size_t)z * w];
+        std::uint64_t* dst = out.grid.Row(z);
+        for (int x = 0; x < w; ++x)
+            dst[x >> 6] |= (std::uint64_t)src[x] << (x & 63);
+    }
+    out.prisms.clear();
+
+    // Reparto uniforme a lo largo del camino, desde la entrada hacia la salida
+    const int len = (int)path.size();
+    for (int i = 1; i <= params.numPrisms; ++i) {
+        int cell = path[len - 1 - (int)((long long)i * (len - 1) / (params.numPrisms + 1))];
+        out.prisms.push_back({ cell % w, cell / w });
+    }
+    return true;
+}
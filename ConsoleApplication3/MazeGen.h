@@ -0,0 +1,21 @@
+// mazegen.h
+// Generador procedural de laberintos con semilla (recursive backtracker con
+// pila explícita). Produce la misma rejilla 0/1 que los ficheros .lvl.
+
+#pragma once
+
+#include <cstdint>
+
+struct LevelData;
+
+struct MazeGenParams {
+    int width = 0;          // celdas de rejilla (incluye muros); mínimo 3
+    int height = 0;
+    std::uint32_t seed = 0;
+    int numPrisms = 0;      // prismas repartidos por el camino solución
+};
+
+// Rellena out.width/height/grid/prisms. La entrada (fila 0) y la salida
+// (última fila) quedan en la columna width / 2, como en los niveles a mano,
+// para que el foyer y la sala final encajen. Texturas y spawn no se tocan.
+bool MazeGen_Generate(const MazeGenParams& params, LevelData& out);
@@ -0,0 +1,150 @@
+// parallel.cpp
+// Grupo de hilos de ParallelFor. Cada llamada publica su trabajo en una
+// lista; los hilos libres y el que llama toman bloques de índices con un
+// contador atómico. Los hilos atienden primero el trabajo más reciente, que
+// en llamadas anidadas es el que desbloquea a los de fuera.
+
+#include "Parallel.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Bloques por hilo: reparte mejor cuando las iteraciones cuestan distinto
+static const int PARALLEL_BLOCKS_PER_THREAD = 4;
+
+struct ParallelJob {
+    int count = 0;
+    int grain = 1;                    // índices por bloque
+    void (*fn)(const void*, int) = nullptr;
+    const void* ctx = nullptr;
+    std::atomic<int> next{ 0 };       // primer índice sin tomar
+    int users = 0;                    // hilos del grupo dentro (con m_Mutex)
+};
+
+class ThreadPool {
+public:
+    ThreadPool()
+    {
+        const int n = std::clamp((int)std::thread::hardware_concurrency() - 1, 0, 63);
+        for (int i = 0; i < n; ++i)
+            m_Threads.emplace_back([this] { WorkerLoop(); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Quit = true;
+        }
+        m_Wake.notify_all();
+        for (auto& t : m_Threads)
+            t.join();
+    }
+
+    int ThreadCount() const { return (int)m_Threads.size() + 1; }
+
+    void Run(ParallelJob& job)
+    {
+        if (m_Threads.empty() || job.count <= job.grain) {
+            Work(job);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Jobs.push_back(&job);
+        }
+        m_Wake.notify_all();
+
+        Work(job);
+
+        // Ya no quedan bloques sin tomar: esperar a los que están en otros hilos
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        Remove(job);
+        m_Done.wait(lock, [&] { return job.users == 0; });
+    }
+
+private:
+    static void Work(ParallelJob& job)
+    {
+        for (;;) {
+            const int begin = job.next.fetch_add(job.grain);
+            if (begin >= job.count)
+                return;
+            const int end = std::min(job.count, begin + job.grain);
+            for (int i = begin; i < end; ++i)
+                job.fn(job.ctx, i);
+        }
+    }
+
+    // Con m_Mutex tomado
+    void Remove(ParallelJob& job)
+    {
+        auto it = std::find(m_Jobs.begin(), m_Jobs.end(), &job);
+        if (it != m_Jobs.end())
+            m_Jobs.erase(it);
+    }
+
+    void WorkerLoop()
+    {
+        Profiler_SetThreadName("ParallelFor");
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        for (;;) {
+            m_Wake.wait(lock, [&] { return m_Quit || !m_Jobs.empty(); });
+            if (m_Quit)
+                return;
+
+            ParallelJob& job = *m_Jobs.back();
+            ++job.users;
+            lock.unlock();
+            Work(job);
+            lock.lock();
+
+            // Agotado: fuera de la lista para que nadie más lo tome
+            Remove(job);
+            if (--job.users == 0)
+                m_Done.notify_all();
+        }
+    }
+
+    std::vector<std::thread> m_Threads;
+    std::mutex m_Mutex;
+    std::condition_variable m_Wake;    // hay trabajo o hay que salir
+    std::condition_variable m_Done;    // un hilo salió de un trabajo
+    std::vector<ParallelJob*> m_Jobs;  // con bloques por tomar
+    bool m_Quit = false;
+};
+
+static ThreadPool& Pool()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+} // namespace
+
+void Parallel_Run(int count, void (*fn)(const void* ctx, int i), const void* ctx)
+{
+    if (count <= 0)
+        return;
+
+    ThreadPool& pool = Pool();
+    ParallelJob job;
+    job.count = count;
+    job.grain = std::max(1, count / (pool.ThreadCount() * PARALLEL_BLOCKS_PER_THREAD));
+    job.fn = fn;
+    job.ctx = ctx;
+    pool.Run(job);
+}
+
+int Parallel_ThreadCount()
+{
+    return Pool().ThreadCount();
+}
@@ -0,0 +1,20 @@
+// parallel.h
+// Reparto de trabajo para las cargas (texturas, cielo, PVS...) entre un grupo
+// fijo de hilos que se crea en la primera llamada y duerme entre trabajos.
+
+#pragma once
+
+// Ejecuta fn(ctx, i) para i en [0, count). El hilo que llama también trabaja
+// y solo espera a los bloques que ya tomaron otros hilos, así que se puede
+// llamar desde dentro de otro trabajo (trabajos anidados) sin bloquearse.
+void Parallel_Run(int count, void (*fn)(const void* ctx, int i), const void* ctx);
+
+// Hilos que pueden trabajar a la vez: los del grupo más el que llama
+int Parallel_ThreadCount();
+
+// Ejecuta fn(i) para i en [0, count) repartiendo bloques contiguos entre hilos
+template <typename Fn>
+void ParallelFor(int count, const Fn& fn)
+{
+    Parallel_Run(count, [](const void* ctx, int i) { (*static_cast<const Fn*>(ctx))(i); }, &fn);
+}
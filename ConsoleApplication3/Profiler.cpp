@@ -0,0 +1,434 @@
+// profiler.cpp
+// Anillo de frames sin bloqueos: el hilo principal escribe siempre en el slot
+// del frame en curso y publica el contador de frames terminados con
+// memory_order_release; la ventana lee solo frames ya publicados.
+// La captura de trazas usa un búfer por hilo y un hilo escritor aparte.
+
+#include "Profiler.h"
+
+#include "imgui.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+static const int PROFILER_HISTORY = 240;      // ~4 s a 60 fps
+static const int PROFILER_MAX_EVENTS = 64;    // ámbitos por frame
+static const int PROFILER_MAX_COUNTERS = 16;  // contadores con nombre por frame
+
+struct ProfileEvent {
+    const char* name;
+    int   depth;
+    float startMs;   // desde el inicio del frame
+    float durMs;
+};
+
+struct ProfileCounter {
+    const char* name;
+    double value;
+};
+
+struct ProfileFrame {
+    float frameMs = 0.0f;   // de un Profiler_EndFrame al siguiente
+    int   drawCalls = 0;
+    int   vertices = 0;
+    int   numEvents = 0;
+    ProfileEvent events[PROFILER_MAX_EVENTS];
+    int   numCounters = 0;
+    ProfileCounter counters[PROFILER_MAX_COUNTERS];
+};
+
+using Clock = std::chrono::steady_clock;
+
+// El slot g_FramesDone % HISTORY es el frame en curso; los HISTORY - 1
+// anteriores son los publicados.
+static ProfileFrame g_Frames[PROFILER_HISTORY];
+static std::atomic<std::uint64_t> g_FramesDone{ 0 };
+
+static Clock::time_point g_FrameStart = Clock::now();
+static int g_Depth = 0;
+static const std::thread::id g_MainThread = std::this_thread::get_id();
+
+static inline ProfileFrame& CurrentFrame()
+{
+    return g_Frames[g_FramesDone.load(std::memory_order_relaxed) % PROFILER_HISTORY];
+}
+
+static inline float MsSinceFrameStart(Clock::time_point t)
+{
+    return std::chrono::duration<float, std::milli>(t - g_FrameStart).count();
+}
+
+} // namespace
+
+ProfileScope::ProfileScope(const char* name)
+    : m_Name(name), m_Start(Clock::now()), m_Event(-1)
+{
+    if (std::this_thread::get_id() != g_MainThread)
+        return;
+
+    ProfileFrame& f = CurrentFrame();
+    if (f.numEvents < PROFILER_MAX_EVENTS) {
+        m_Event = f.numEvents++;
+        f.events[m_Event] = { name, g_Depth, MsSinceFrameStart(m_Start), 0.0f };
+    }
+    ++g_Depth;
+}
+
+ProfileScope::~ProfileScope()
+{
+    Clock::time_point end = Clock::now();
+    if (Profiler_IsCapturing())
+        Profiler_TraceComplete(m_Name, m_Start, end);
+
+    if (std::this_thread::get_id() != g_MainThread)
+        return;
+
+    --g_Depth;
+    if (m_Event >= 0) {
+        ProfileEvent& e = CurrentFrame().events[m_Event];
+        e.durMs = MsSinceFrameStart(end) - e.startMs;
+    }
+}
+
+void Profiler_EndFrame()
+{
+    Clock::time_point now = Clock::now();
+    CurrentFrame().frameMs = MsSinceFrameStart(now);
+
+    g_FramesDone.fetch_add(1, std::memory_order_release);
+    g_FrameStart = now;
+
+    ProfileFrame& next = CurrentFrame();
+    next.frameMs = 0.0f;
+    next.drawCalls = 0;
+    next.vertices = 0;
+    next.numEvents = 0;
+    next.numCounters = 0;
+}
+
+void Profiler_CountDraw(int vertices)
+{
+    ProfileFrame& f = CurrentFrame();
+    ++f.drawCalls;
+    f.vertices += vertices;
+}
+
+void Profiler_SetCounter(const char* name, double value)
+{
+    ProfileFrame& f = CurrentFrame();
+    for (int i = 0; i < f.numCounters; ++i)
+        if (f.counters[i].name == name) {
+            f.counters[i].value = value;
+            return;
+        }
+    if (f.numCounters < PROFILER_MAX_COUNTERS)
+        f.counters[f.numCounters++] = { name, value };
+}
+
+// -----------------------------------------------------------------------------
+// Ventana de ImGui
+// -----------------------------------------------------------------------------
+
+void Profiler_DrawImGui(bool* open)
+{
+    const std::uint64_t done = g_FramesDone.load(std::memory_order_acquire);
+    const int count = (int)std::min<std::uint64_t>(done, PROFILER_HISTORY - 1);
+
+    ImGui::SetNextWindowSize(ImVec2(420, 360), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Profiler", open)) {
+        ImGui::End();
+        return;
+    }
+    if (count == 0) {
+        ImGui::TextUnformatted("Sin frames todavia");
+        ImGui::End();
+        return;
+    }
+
+    // Frames publicados, del más antiguo al más reciente
+    auto frameAt = [&](int i) -> const ProfileFrame& {
+        return g_Frames[(done - count + i) % PROFILER_HISTORY];
+    };
+
+    std::vector<float> frameMs(count);
+    float sumMs = 0.0f, maxMs = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        frameMs[i] = frameAt(i).frameMs;
+        sumMs += frameMs[i];
+        maxMs = std::max(maxMs, frameMs[i]);
+    }
+
+    const ProfileFrame& last = frameAt(count - 1);
+    ImGui::Text("Frame: %.2f ms (media %.2f, max %.2f)", last.frameMs, sumMs / count, maxMs);
+    ImGui::PlotLines("##frame", frameMs.data(), count, 0, nullptr,
+        0.0f, std::max(33.3f, maxMs), ImVec2(-1, 60));
+    ImGui::Text("Draw calls: %d   Vertices: %d", last.drawCalls, last.vertices);
+    for (int i = 0; i < last.numCounters; ++i)
+        ImGui::Text("%s: %g", last.counters[i].name, last.counters[i].value);
+    ImGui::Separator();
+
+    // Ámbitos del último frame (orden y sangría del árbol) con media y máximo
+    // sobre el historial, agrupando por nombre y profundidad
+    if (ImGui::BeginTable("scopes", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV)) {
+        ImGui::TableSetupColumn("Ambito");
+        ImGui::TableSetupColumn("Ultimo", ImGuiTableColumnFlags_WidthFixed, 60);
+        ImGui::TableSetupColumn("Media", ImGuiTableColumnFlags_WidthFixed, 60);
+        ImGui::TableSetupColumn("Max", ImGuiTableColumnFlags_WidthFixed, 60);
+        ImGui::TableHeadersRow();
+
+        for (int e = 0; e < last.numEvents; ++e) {
+            const ProfileEvent& ev = last.events[e];
+
+            float sum = 0.0f, mx = 0.0f;
+            for (int i = 0; i < count; ++i) {
+                const ProfileFrame& f = frameAt(i);
+                float frameSum = 0.0f;
+                for (int k = 0; k < f.numEvents; ++k)
+                    if (f.events[k].name == ev.name && f.events[k].depth == ev.depth)
+                        frameSum += f.events[k].durMs;
+                sum += frameSum;
+                mx = std::max(mx, frameSum);
+            }
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            if (ev.depth > 0) ImGui::Indent(ev.depth * 12.0f);
+            ImGui::TextUnformatted(ev.name);
+            if (ev.depth > 0) ImGui::Unindent(ev.depth * 12.0f);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", ev.durMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", sum / count);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", mx);
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+
+// -----------------------------------------------------------------------------
+// Captura de trazas (formato JSON de Chrome)
+// -----------------------------------------------------------------------------
+
+namespace {
+
+static const int TRACE_FLUSH_MS = 50;
+
+struct TraceEvent {
+    const char* name;
+    char  phase;          // 'X' = con duración, 'i' = instantáneo
+    double tsUs;
+    double durUs;
+};
+
+// Búfer de un hilo. El mutex solo lo comparten su hilo y el escritor (que lo
+// toma un instante para intercambiar vectores), así que casi nunca espera.
+struct ThreadTraceBuffer {
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+    std::string name;
+    int tid = 0;
+    bool nameWritten = false;
+};
+
+static std::atomic<bool> g_Capturing{ false };
+static Clock::time_point g_TraceEpoch;
+
+static std::mutex g_TraceMutex;   // registro de búferes y estado del escritor
+static std::vector<std::shared_ptr<ThreadTraceBuffer>> g_TraceBuffers;
+static std::condition_variable g_TraceWake;
+static std::thread g_TraceWriter;
+static bool g_TraceStop = false;
+static FILE* g_TraceFile = nullptr;
+static bool g_TraceFirstEvent = true;
+
+static ThreadTraceBuffer& LocalTraceBuffer()
+{
+    thread_local std::shared_ptr<ThreadTraceBuffer> local;
+    if (!local) {
+        local = std::make_shared<ThreadTraceBuffer>();
+        std::lock_guard<std::mutex> lock(g_TraceMutex);
+        local->tid = (int)g_TraceBuffers.size() + 1;
+        g_TraceBuffers.push_back(local);
+    }
+    return *local;
+}
+
+static void PushTraceEvent(const TraceEvent& e)
+{
+    ThreadTraceBuffer& buf = LocalTraceBuffer();
+    std::lock_guard<std::mutex> lock(buf.mutex);
+    buf.events.push_back(e);
+}
+
+static inline double UsSinceEpoch(Clock::time_point t)
+{
+    return std::chrono::duration<double, std::micro>(t - g_TraceEpoch).count();
+}
+
+// Los nombres son literales del código: basta con escapar comillas y barras
+static void WriteJsonString(FILE* f, const char* s)
+{
+    std::fputc('"', f);
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') std::fputc('\\', f);
+        std::fputc(*s, f);
+    }
+    std::fputc('"', f);
+}
+
+static void WriteEventPrefix(FILE* f)
+{
+    std::fputs(g_TraceFirstEvent ? "\n" : ",\n", f);
+    g_TraceFirstEvent = false;
+}
+
+// Vuelca al fichero lo acumulado por todos los hilos (solo el escritor)
+static void FlushTraceBuffers()
+{
+    std::vector<std::shared_ptr<ThreadTraceBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(g_TraceMutex);
+        buffers = g_TraceBuffers;
+    }
+
+    std::vector<TraceEvent> events;
+    for (const auto& buf : buffers) {
+        std::string name;
+        {
+            std::lock_guard<std::mutex> lock(buf->mutex);
+            events.swap(buf->events);
+            if (!buf->nameWritten && !buf->name.empty()) {
+                name = buf->name;
+                buf->nameWritten = true;
+            }
+        }
+
+        if (!name.empty()) {
+            WriteEventPrefix(g_TraceFile);
+            std::fprintf(g_TraceFile,
+                "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", buf->tid);
+            WriteJsonString(g_TraceFile, name.c_str());
+            std::fputs("}}", g_TraceFile);
+        }
+
+        for (const TraceEvent& e : events) {
+            WriteEventPrefix(g_TraceFile);
+            std::fputs("{\"name\":", g_TraceFile);
+            WriteJsonString(g_TraceFile, e.name);
+            if (e.phase == 'X')
+                std::fprintf(g_TraceFile, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                    e.tsUs, e.durUs, buf->tid);
+            else
+                std::fprintf(g_TraceFile, ",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                    e.tsUs, buf->tid);
+        }
+        events.clear();   // se reutiliza la capacidad en el siguiente búfer
+    }
+    std::fflush(g_TraceFile);
+}
+
+static void TraceWriterLoop()
+{
+    std::unique_lock<std::mutex> lock(g_TraceMutex);
+    while (!g_TraceStop) {
+        g_TraceWake.wait_for(lock, std::chrono::milliseconds(TRACE_FLUSH_MS));
+        lock.unlock();
+        FlushTraceBuffers();
+        lock.lock();
+    }
+}
+
+} // namespace
+
+bool Profiler_StartCapture(const char* path)
+{
+    if (g_Capturing.load())
+        return true;
+
+    g_TraceFile = std::fopen(path, "w");
+    if (!g_TraceFile) {
+        std::cerr << "No se pudo crear la traza: " << path << std::endl;
+        return false;
+    }
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", g_TraceFile);
+    g_TraceFirstEvent = true;
+
+    // Eventos que quedaran de una captura anterior ya no valen
+    {
+        std::lock_guard<std::mutex> lock(g_TraceMutex);
+        for (const auto& buf : g_TraceBuffers) {
+            std::lock_guard<std::mutex> bufLock(buf->mutex);
+            buf->events.clear();
+            buf->nameWritten = false;
+        }
+        g_TraceStop = false;
+    }
+
+    g_TraceEpoch = Clock::now();
+    g_TraceWriter = std::thread(TraceWriterLoop);
+    g_Capturing.store(true, std::memory_order_release);
+    std::cout << "Capturando traza en " << path << std::endl;
+    return true;
+}
+
+void Profiler_StopCapture()
+{
+    if (!g_Capturing.exchange(false))
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(g_TraceMutex);
+        g_TraceStop = true;
+    }
+    g_TraceWake.notify_one();
+    g_TraceWriter.join();
+
+    FlushTraceBuffers();
+    std::fputs("\n]}\n", g_TraceFile);
+    std::fclose(g_TraceFile);
+    g_TraceFile = nullptr;
+    std::cout << "Traza terminada" << std::endl;
+}
+
+bool Profiler_IsCapturing()
+{
+    return g_Capturing.load(std::memory_order_acquire);
+}
+
+void Profiler_SetThreadName(const char* name)
+{
+    ThreadTraceBuffer& buf = LocalTraceBuffer();
+    std::lock_guard<std::mutex> lock(buf.mutex);
+    buf.name = name;
+    buf.nameWritten = false;
+}
+
+void Profiler_TraceComplete(const char* name, Clock::time_point start, Clock::time_point end)
+{
+    if (!Profiler_IsCapturing())
+        return;
+    double ts = UsSinceEpoch(start);
+    PushTraceEvent({ name, 'X', ts, UsSinceEpoch(end) - ts });
+}
+
+void Profiler_TraceInstant(const char* name)
+{
+    if (!Profiler_IsCapturing())
+        return;
+    PushTraceEvent({ name, 'i', UsSinceEpoch(Clock::now()), 0.0 });
+}
@@ -0,0 +1,66 @@
+// profiler.h
+// Perfilador de frame: temporizadores de ámbito jerárquicos, contadores de
+// draw calls / vértices, una ventana de ImGui para verlos y captura de
+// trazas en formato JSON de Chrome (chrome://tracing, ui.perfetto.dev).
+
+#pragma once
+
+#include <chrono>
+
+// Mide el ámbito actual con el nombre dado (cadena literal: se guarda el
+// puntero). La ventana solo muestra el hilo principal; durante una captura
+// se registran los ámbitos de todos los hilos.
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name);
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_Name;
+    std::chrono::steady_clock::time_point m_Start;
+    int m_Event;   // índice en el frame en curso, -1 si no se registra
+};
+
+// Evento instantáneo en la traza (abrir/cerrar puzzle, etc.)
+#define PROFILE_EVENT(name) Profiler_TraceInstant(name)
+
+// Cierra el frame en curso y abre el siguiente (al final de display())
+void Profiler_EndFrame();
+
+// Suma una llamada de dibujo con 'vertices' vértices al frame en curso
+void Profiler_CountDraw(int vertices);
+
+// Valor de un contador con nombre (cadena literal) en el frame en curso; la
+// ventana muestra los del último frame. Solo hilo principal.
+void Profiler_SetCounter(const char* name, double value);
+
+// Ventana con gráfica de tiempo de frame, medias y máximos por ámbito y
+// contadores. 'open' lo pone a false el botón de cerrar.
+void Profiler_DrawImGui(bool* open);
+
+// -----------------------------------------------------------------------------
+// Captura de trazas
+// -----------------------------------------------------------------------------
+// Cada hilo añade eventos a su propio búfer; un hilo escritor los vacía al
+// fichero cada pocos ms, así que la captura apenas cambia el frame.
+
+bool Profiler_StartCapture(const char* path);
+void Profiler_StopCapture();
+bool Profiler_IsCapturing();
+
+// Nombre del hilo actual en la traza
+void Profiler_SetThreadName(const char* name);
+
+// Evento con duración medido fuera de un ProfileScope (fases de render)
+void Profiler_TraceComplete(const char* name,
+    std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point end);
+
+void Profiler_TraceInstant(const char* name);
@@ -1,5 +1,6 @@
 // puzzles.cpp
 #include "imgui.h"
+#include "Profiler.h"
 #include <vector>
 #include <string>
 #include <cstring>
@@ -45,6 +46,7 @@ extern bool g_PrismIsRed;
 // Estado para gestionar mensajes y cierre diferido
 static bool g_WaitingAutoClose = false;
 static int  g_AutoCloseStartMs = 0;
+static const int AUTO_CLOSE_MS = 2500;   // mensaje de acierto antes de cerrar
 static bool g_PendingFailPopup = false;
 
 // API de world.cpp
@@ -65,9 +67,6 @@ extern LevelDifficulty g_CurrentLevel;
 static std::mt19937 g_SrxRngPuzzle{ std::random_device{}() };
 
 extern void World_SetNarratorLine(const char* text, int durationMs);
-extern const char* SrxGetSuccessLine();
-extern const char* SrxGetFailureLineForPuzzle(int idx);
-extern const char* SrxGetGiveUpLine();
 
 static bool g_HasQueuedNarrator = false;
 static std::string g_QueuedNarratorLine;
@@ -1000,6 +999,7 @@ extern bool g_PrismIsRed;   // desde World.cpp (true en nivel fácil)
 
 void Puzzles_Init(int numPrisms)
 {
+    PROFILE_SCOPE("Puzzles_Init");
     g_Puzzles.clear();
 
     // g_PrismIsRed controla el "modo amable" (sin SRX / sin insultos).
@@ -1066,6 +1066,8 @@ void Puzzles_OpenForPrism(int index)
     if (index < 0 || g_Puzzles.empty())
         return;
 
+    PROFILE_EVENT("Puzzle abierto");
+
     // Si hay más prismas que puzzles (caso nivel medio),
     // reutilizamos puzzles de forma circular.
     int idx = index % (int)g_Puzzles.size();
@@ -1090,6 +1092,15 @@ bool Puzzles_IsOpen()
     return g_IsOpen;
 }
 
+// Ms hasta el cierre automático tras acertar; -1 si no hay ninguno pendiente
+int Puzzles_NextAnimationMs()
+{
+    if (!g_IsOpen || !g_WaitingAutoClose)
+        return -1;
+    int left = g_AutoCloseStartMs + AUTO_CLOSE_MS - glutGet(GLUT_ELAPSED_TIME);
+    return std::max(1, left);
+}
+
 // ========================================================
 //  Dibujo de cada puzzle (UI con ImGui)
 // ========================================================
@@ -1748,7 +1759,7 @@ void Puzzles_DrawImGui()
             "Correcto: la solución es coherente. Cerrando puzzle.");
 
         int now = glutGet(GLUT_ELAPSED_TIME);
-        if (now - g_AutoCloseStartMs >= 2500)
+        if (now - g_AutoCloseStartMs >= AUTO_CLOSE_MS)
         {
             g_IsOpen = false;
             g_ActivePuzzle = -1;
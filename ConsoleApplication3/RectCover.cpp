@@ -0,0 +1,342 @@
+// rectcover.cpp
+// Greedy por filas y partición mínima en rectángulos de un polígono
+// rectilíneo (con agujeros) formado por celdas.
+//
+// Partición mínima: el número de rectángulos es R - L + 1 - H por
+// componente (R vértices cóncavos, H agujeros, L máximo de cuerdas entre
+// vértices cóncavos que no se cortan). Las cuerdas horizontales y verticales
+// forman un grafo bipartito por intersección; L es su conjunto independiente
+// máximo (König: cuerdas - emparejamiento máximo). Se corta por esas cuerdas
+// y desde cada vértice cóncavo que quede se lanza un corte hasta el borde o
+// un corte previo; lo que queda son rectángulos.
+
+#include "RectCover.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+
+namespace {
+
+static void GreedyCover(const BitGrid& grid, std::vector<CellRect>& out)
+{
+    std::vector<std::uint64_t> words = grid.Words();
+    auto emit = [&](const CellRect& r) { out.push_back(r); };
+    RectCover_GreedyScan(grid.Width(), grid.Height(), words.data(), grid.RowWords(), emit);
+}
+
+// Flags por vértice de la retícula ((w + 1) x (h + 1) puntos)
+static const std::uint8_t REFLEX   = 1;   // exactamente 3 de sus 4 celdas son muro
+static const std::uint8_t H_POS    = 2;   // su corte horizontal va hacia +x
+static const std::uint8_t V_POS    = 4;   // su corte vertical va hacia +z
+static const std::uint8_t RESOLVED = 8;   // ya sale un corte de él
+
+// Cuerda entre dos vértices cóncavos: sobre la línea 'line', de lo a hi
+struct Chord {
+    int line, lo, hi;
+};
+
+class MinimumCover {
+public:
+    explicit MinimumCover(const BitGrid& grid)
+        : m_Grid(grid), m_W(grid.Width()), m_H(grid.Height()), m_PW(grid.Width() + 1),
+          m_Point((size_t)(m_W + 1) * (m_H + 1), 0),
+          m_HCut((size_t)m_W * (m_H + 1), 0),
+          m_VCut((size_t)(m_W + 1) * m_H, 0)
+    {
+    }
+
+    void Build(std::vector<CellRect>& out)
+    {
+        FindReflexVertices();
+        FindChords();
+        CutIndependentChords();
+        CutRemainingVertices();
+        ExtractRects(out);
+    }
+
+private:
+    bool Filled(int x, int z) const
+    {
+        return m_Grid.Test(x, z);
+    }
+
+    // Tramo unidad de la línea horizontal z entre x y x + 1 con muro a ambos lados
+    bool HInterior(int x, int z) const { return Filled(x, z - 1) && Filled(x, z); }
+    // Tramo unidad de la línea vertical x entre z y z + 1
+    bool VInterior(int x, int z) const { return Filled(x - 1, z) && Filled(x, z); }
+
+    std::uint8_t& Point(int x, int z) { return m_Point[(size_t)z * m_PW + x]; }
+    std::uint8_t& HCut(int x, int z) { return m_HCut[(size_t)z * m_W + x]; }
+    std::uint8_t& VCut(int x, int z) { return m_VCut[(size_t)z * m_PW + x]; }
+
+    // 64 vértices por palabra: el vértice x de la línea z toca las celdas
+    // x - 1 y x de las filas z - 1 y z
+    void FindReflexVertices()
+    {
+        const int words = (m_PW + 63) >> 6;
+        for (int z = 0; z <= m_H; ++z) {
+            for (int k = 0; k < words; ++k) {
+                const std::uint64_t nw = m_Grid.Neighbours(z - 1, k, -1);
+                const std::uint64_t ne = m_Grid.Neighbours(z - 1, k, 0);
+                const std::uint64_t sw = m_Grid.Neighbours(z, k, -1);
+                const std::uint64_t se = m_Grid.Neighbours(z, k, 0);
+                std::uint64_t three = (nw & ne & sw & ~se) | (nw & ne & ~sw & se) |
+                                      (nw & ~ne & sw & se) | (~nw & ne & sw & se);
+                while (three) {
+                    const int b = Bits_LowestSet(three);
+                    three &= three - 1;
+                    // Los dos cortes salen en sentido contrario a la celda libre
+                    std::uint8_t f = REFLEX;
+                    if (!((nw & sw) >> b & 1)) f |= H_POS;
+                    if (!((nw & ne) >> b & 1)) f |= V_POS;
+                    Point((k << 6) + b, z) = f;
+                }
+            }
+        }
+    }
+
+    // Recorre desde cada vértice cóncavo que mira a +x (+z) hasta el primer
+    // vértice de la línea; es cuerda si este mira de vuelta.
+    void FindChords()
+    {
+        for (int z = 0; z <= m_H; ++z) {
+            for (int x = 0; x <= m_W; ++x) {
+                std::uint8_t f = Point(x, z);
+                if (!(f & REFLEX))
+                    continue;
+                if (f & H_POS) {
+                    int e = x;
+                    while (e < m_W && HInterior(e, z) && !(Point(e + 1, z) & REFLEX)) ++e;
+                    if (e < m_W && HInterior(e, z) && !(Point(e + 1, z) & H_POS))
+                        m_HChords.push_back({ z, x, e + 1 });
+                }
+                if (f & V_POS) {
+                    int e = z;
+                    while (e < m_H && VInterior(x, e) && !(Point(x, e + 1) & REFLEX)) ++e;
+                    if (e < m_H && VInterior(x, e) && !(Point(x, e + 1) & V_POS))
+                        m_VChords.push_back({ x, z, e + 1 });
+                }
+            }
+        }
+    }
+
+    // Conjunto independiente máximo del grafo de intersecciones y corte por
+    // las cuerdas elegidas
+    void CutIndependentChords()
+    {
+        const int nh = (int)m_HChords.size();
+        const int nv = (int)m_VChords.size();
+
+        // Cuerda horizontal que pasa por cada punto (no se solapan entre sí)
+        std::vector<int> hAt(m_Point.size(), -1);
+        for (int i = 0; i < nh; ++i)
+            for (int x = m_HChords[i].lo; x <= m_HChords[i].hi; ++x)
+                hAt[(size_t)m_HChords[i].line * m_PW + x] = i;
+
+        // Aristas H -> V en CSR (compartir extremo también cuenta)
+        std::vector<int> start(nh + 1, 0);
+        std::vector<std::pair<int, int>> pairs;
+        for (int j = 0; j < nv; ++j) {
+            const Chord& c = m_VChords[j];
+            for (int z = c.lo; z <= c.hi; ++z) {
+                int i = hAt[(size_t)z * m_PW + c.line];
+                if (i >= 0) pairs.push_back({ i, j });
+            }
+        }
+        for (const auto& p : pairs) ++start[p.first + 1];
+        for (int i = 0; i < nh; ++i) start[i + 1] += start[i];
+        std::vector<int> adj(pairs.size());
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        for (const auto& p : pairs) adj[fill[p.first]++] = p.second;
+
+        std::vector<int> matchH(nh, -1), matchV(nv, -1);
+        HopcroftKarp(start, adj, matchH, matchV);
+
+        // König: alcanzables desde H libres por caminos alternados
+        std::vector<char> seenH(nh, 0), seenV(nv, 0);
+        std::vector<int> stack;
+        for (int i = 0; i < nh; ++i) {
+            if (matchH[i] >= 0) continue;
+            seenH[i] = 1;
+            stack.push_back(i);
+        }
+        while (!stack.empty()) {
+            int i = stack.back();
+            stack.pop_back();
+            for (int k = start[i]; k < start[i + 1]; ++k) {
+                int j = adj[k];
+                if (seenV[j]) continue;
+                seenV[j] = 1;
+                int next = matchV[j];
+                if (next >= 0 && !seenH[next]) {
+                    seenH[next] = 1;
+                    stack.push_back(next);
+                }
+            }
+        }
+
+        // Independiente = H alcanzables + V no alcanzables
+        for (int i = 0; i < nh; ++i) {
+            if (!seenH[i]) continue;
+            const Chord& c = m_HChords[i];
+            for (int x = c.lo; x < c.hi; ++x) HCut(x, c.line) = 1;
+            Point(c.lo, c.line) |= RESOLVED;
+            Point(c.hi, c.line) |= RESOLVED;
+        }
+        for (int j = 0; j < nv; ++j) {
+            if (seenV[j]) continue;
+            const Chord& c = m_VChords[j];
+            for (int z = c.lo; z < c.hi; ++z) VCut(c.line, z) = 1;
+            Point(c.line, c.lo) |= RESOLVED;
+            Point(c.line, c.hi) |= RESOLVED;
+        }
+    }
+
+    static void HopcroftKarp(const std::vector<int>& start, const std::vector<int>& adj,
+        std::vector<int>& matchH, std::vector<int>& matchV)
+    {
+        const int nh = (int)matchH.size();
+        const int INF = 0x7FFFFFFF;
+        std::vector<int> dist(nh);
+        std::vector<int> it(nh);
+        std::vector<int> path;
+
+        for (;;) {
+            // BFS por capas desde las H libres
+            std::queue<int> q;
+            for (int i = 0; i < nh; ++i) {
+                dist[i] = matchH[i] < 0 ? 0 : INF;
+                if (matchH[i] < 0) q.push(i);
+            }
+            bool found = false;
+            while (!q.empty()) {
+                int i = q.front();
+                q.pop();
+                for (int k = start[i]; k < start[i + 1]; ++k) {
+                    int m = matchV[adj[k]];
+                    if (m < 0) found = true;
+                    else if (dist[m] == INF) {
+                        dist[m] = dist[i] + 1;
+                        q.push(m);
+                    }
+                }
+            }
+            if (!found)
+                return;
+
+            // DFS iterativo por caminos de aumento disjuntos
+            for (int i = 0; i < nh; ++i) it[i] = start[i];
+            for (int root = 0; root < nh; ++root) {
+                if (matchH[root] >= 0) continue;
+                path.assign(1, root);
+                while (!path.empty()) {
+                    int i = path.back();
+                    if (it[i] == start[i + 1]) {
+                        dist[i] = INF;   // sin salida: no volver a probar
+                        path.pop_back();
+                        continue;
+                    }
+                    int j = adj[it[i]++];
+                    int m = matchV[j];
+                    if (m < 0) {
+                        // Aumentar a lo largo de la pila
+                        for (int p = (int)path.size() - 1; p >= 0; --p) {
+                            int h = path[p];
+                            int prev = matchH[h];
+                            matchH[h] = j;
+                            matchV[j] = h;
+                            j = prev;
+                        }
+                        break;
+                    }
+                    if (dist[m] == dist[i] + 1)
+                        path.push_back(m);
+                }
+            }
+        }
+    }
+
+    // ¿Toca el punto algún corte aparte del tramo por el que se ha llegado?
+    bool TouchesCut(int x, int z, int fromDx, int fromDz)
+    {
+        if (x > 0 && fromDx != -1 && HCut(x - 1, z)) return true;
+        if (x < m_W && fromDx != 1 && HCut(x, z)) return true;
+        if (z > 0 && fromDz != -1 && VCut(x, z - 1)) return true;
+        if (z < m_H && fromDz != 1 && VCut(x, z)) return true;
+        return false;
+    }
+
+    bool OnBoundary(int x, int z) const
+    {
+        return !Filled(x - 1, z - 1) || !Filled(x, z - 1) || !Filled(x - 1, z) || !Filled(x, z);
+    }
+
+    // Corte horizontal desde cada vértice cóncavo sin resolver hasta el borde
+    // o hasta otro corte
+    void CutRemainingVertices()
+    {
+        for (int z = 0; z <= m_H; ++z) {
+            for (int x = 0; x <= m_W; ++x) {
+                std::uint8_t f = Point(x, z);
+                if (!(f & REFLEX) || (f & RESOLVED))
+                    continue;
+                const int dx = (f & H_POS) ? 1 : -1;
+                const int dz = (f & V_POS) ? 1 : -1;
+                // Un corte previo que acabó aquí ya lo resuelve
+                if (HCut(dx > 0 ? x : x - 1, z) || VCut(x, dz > 0 ? z : z - 1))
+                    continue;
+
+                int px = x;
+                do {
+                    HCut(dx > 0 ? px : px - 1, z) = 1;
+                    px += dx;
+                } while (!OnBoundary(px, z) && !TouchesCut(px, z, -dx, 0));
+            }
+        }
+    }
+
+    // Cada región entre cortes y bordes es un rectángulo: su celda mínima es
+    // la primera en orden de filas
+    void ExtractRects(std::vector<CellRect>& out)
+    {
+        BitGrid left = m_Grid;   // celdas sin rectángulo
+        for (int z = 0; z < m_H; ++z) {
+            for (int x = BitRow_NextSet(left.Row(z), 0, m_W); x < m_W;
+                 x = BitRow_NextSet(left.Row(z), x, m_W)) {
+                int w = 1;
+                while (Filled(x + w, z) && !VCut(x + w, z)) ++w;
+                int l = 1;
+                while (Filled(x, z + l) && !HCut(x, z + l)) ++l;
+
+                for (int dz = 0; dz < l; ++dz)
+                    BitRow_ClearRange(left.Row(z + dz), x, w);
+                out.push_back({ x, z, w, l });
+            }
+        }
+    }
+
+    const BitGrid& m_Grid;
+    const int m_W, m_H, m_PW;
+    std::vector<std::uint8_t> m_Point;
+    std::vector<std::uint8_t> m_HCut;   // línea z, tramo x..x+1: w * (h + 1)
+    std::vector<std::uint8_t> m_VCut;   // línea x, tramo z..z+1: (w + 1) * h
+    std::vector<Chord> m_HChords;
+    std::vector<Chord> m_VChords;
+};
+
+} // namespace
+
+const char* RectCover_Name(RectCoverMode mode)
+{
+    return mode == RectCoverMode::Minimum ? "minimum" : "greedy";
+}
+
+void RectCover_Build(const BitGrid& grid, RectCoverMode mode, std::vector<CellRect>& out)
+{
+    out.clear();
+    if (mode == RectCoverMode::Minimum)
+        MinimumCover(grid).Build(out);
+    else
+        GreedyCover(grid, out);
+}
@@ -0,0 +1,50 @@
+// rectcover.h
+// Descomposición de las celdas muro de una rejilla de bits en rectángulos
+// disjuntos: greedy por filas (rápido) o partición mínima (menos
+// rectángulos, más cara de calcular).
+
+#pragma once
+
+#include "BitGrid.h"
+
+#include <vector>
+
+struct CellRect {
+    int x, z, w, l;   // celda mínima y tamaño en celdas
+};
+
+enum class RectCoverMode {
+    Greedy,    // crece cada rectángulo a lo ancho y luego hacia abajo
+    Minimum,   // partición mínima por cuerdas + emparejamiento bipartito
+};
+
+const char* RectCover_Name(RectCoverMode mode);
+
+// Greedy por filas sobre filas de bits (rowWords palabras por fila): cada
+// rectángulo toma el tramo de muro más a la izquierda de la fila y baja
+// mientras las filas siguientes lo tengan entero. Borra de 'words' lo que va
+// cubriendo y pasa cada rectángulo a emit(rect). Es constexpr para que
+// World.cpp hornee en compilación los laberintos integrados con el mismo
+// código.
+template <typename Emit>
+constexpr void RectCover_GreedyScan(int width, int height, std::uint64_t* words, int rowWords, Emit& emit)
+{
+    for (int z = 0; z < height; ++z) {
+        std::uint64_t* row = words + (size_t)z * rowWords;
+        for (int x = BitRow_NextSet(row, 0, width); x < width; x = BitRow_NextSet(row, x, width)) {
+            const int w = BitRow_NextClear(row, x, width) - x;
+
+            int l = 1;
+            while (z + l < height && BitRow_AllSet(row + (size_t)l * rowWords, x, w))
+                ++l;
+            for (int dz = 0; dz < l; ++dz)
+                BitRow_ClearRange(row + (size_t)dz * rowWords, x, w);
+
+            emit(CellRect{ x, z, w, l });
+        }
+    }
+}
+
+// Rellena 'out' con rectángulos que cubren exactamente las celdas muro de
+// 'grid', sin solaparse.
+void RectCover_Build(const BitGrid& grid, RectCoverMode mode, std::vector<CellRect>& out);
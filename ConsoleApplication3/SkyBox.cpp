@@ -0,0 +1,159 @@
+// skybox.cpp
+// Remuestreo equirectangular -> cubo en CPU con varios hilos.
+
+#include "SkyBox.h"
+#include "AssetPack.h"
+#include "Parallel.h"
+#include "Profiler.h"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+static const int SKY_FACE_MIN = 64;
+static const int SKY_FACE_MAX = 1024;
+
+// m = Ry(yaw) * Rx(pitch) * Rz(roll), igual que la secuencia de glRotatef
+static void BuildRotation(const SkyOrientation& o, float m[3][3])
+{
+    const float d2r = (float)M_PI / 180.0f;
+    float cy = cosf(o.yawDeg * d2r), sy = sinf(o.yawDeg * d2r);
+    float cp = cosf(o.pitchDeg * d2r), sp = sinf(o.pitchDeg * d2r);
+    float cr = cosf(o.rollDeg * d2r), sr = sinf(o.rollDeg * d2r);
+
+    float ry[3][3] = { { cy, 0, sy }, { 0, 1, 0 }, { -sy, 0, cy } };
+    float rx[3][3] = { { 1, 0, 0 }, { 0, cp, -sp }, { 0, sp, cp } };
+    float rz[3][3] = { { cr, -sr, 0 }, { sr, cr, 0 }, { 0, 0, 1 } };
+
+    float tmp[3][3];
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            tmp[i][j] = ry[i][0] * rx[0][j] + ry[i][1] * rx[1][j] + ry[i][2] * rx[2][j];
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            m[i][j] = tmp[i][0] * rz[0][j] + tmp[i][1] * rz[1][j] + tmp[i][2] * rz[2][j];
+}
+
+// Bilineal con repetición en u (360°) y recorte en v (polos); escribe RGBA
+static void SampleEquirect(const unsigned char* src, int w, int h,
+    float u, float v, unsigned char* out)
+{
+    float fx = u * w - 0.5f;
+    float fy = std::clamp(v * h - 0.5f, 0.0f, (float)(h - 1));
+    int x0 = (int)std::floor(fx);
+    int y0 = (int)fy;
+    float tx = fx - x0;
+    float ty = fy - y0;
+    x0 = ((x0 % w) + w) % w;
+    int x1 = (x0 + 1) % w;
+    int y1 = std::min(h - 1, y0 + 1);
+
+    const unsigned char* p00 = src + ((size_t)y0 * w + x0) * 3;
+    const unsigned char* p10 = src + ((size_t)y0 * w + x1) * 3;
+    const unsigned char* p01 = src + ((size_t)y1 * w + x0) * 3;
+    const unsigned char* p11 = src + ((size_t)y1 * w + x1) * 3;
+    for (int c = 0; c < 3; ++c) {
+        float top = p00[c] + (p10[c] - p00[c]) * tx;
+        float bot = p01[c] + (p11[c] - p01[c]) * tx;
+        out[c] = (unsigned char)(top + (bot - top) * ty + 0.5f);
+    }
+    out[3] = 255;
+}
+
+// Cara potencia de dos que conserva la resolución del ecuador (w / 4)
+static int FaceSizeFor(int equirectW)
+{
+    int n = SKY_FACE_MIN;
+    while (n * 2 <= equirectW / 4 && n < SKY_FACE_MAX) n *= 2;
+    return n;
+}
+
+} // namespace
+
+void SkyBox_FaceDirection(int face, float s, float t, float dir[3])
+{
+    float sc = 2.0f * s - 1.0f;
+    float tc = 2.0f * t - 1.0f;
+    switch (face) {
+    case SKY_POS_X: dir[0] = 1.0f; dir[1] = -tc;   dir[2] = -sc;  break;
+    case SKY_NEG_X: dir[0] = -1.0f; dir[1] = -tc;  dir[2] = sc;   break;
+    case SKY_POS_Y: dir[0] = sc;   dir[1] = 1.0f;  dir[2] = tc;   break;
+    case SKY_NEG_Y: dir[0] = sc;   dir[1] = -1.0f; dir[2] = -tc;  break;
+    case SKY_POS_Z: dir[0] = sc;   dir[1] = -tc;   dir[2] = 1.0f; break;
+    default:        dir[0] = -sc;  dir[1] = -tc;   dir[2] = -1.0f; break;
+    }
+}
+
+const char* SkyBox_FaceSuffix(int face)
+{
+    static const char* suffix[SKY_FACES] = { "#px", "#nx", "#py", "#ny", "#pz", "#nz" };
+    return suffix[face];
+}
+
+bool SkyBox_BakeFromEquirect(const char* path, const SkyOrientation& orient, SkyFaces& out)
+{
+    PROFILE_SCOPE("SkyBox_BakeFromEquirect");
+    out = SkyFaces();
+
+    AssetData asset;
+    if (!Asset_Open(path, asset))
+        return false;
+
+    int w, h, ch;
+    unsigned char* src = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(asset.data),
+        (int)asset.size, &w, &h, &ch, 3);
+    if (!src)
+        return false;
+
+    const int n = FaceSizeFor(w);
+    for (auto& f : out.faces) {
+        f.width = f.height = n;
+        f.mips.assign(1, std::vector<unsigned char>((size_t)n * n * 4));
+    }
+
+    float m[3][3];
+    BuildRotation(orient, m);
+
+    // Cada fila de cada cara es independiente: 6 * n filas a repartir
+    ParallelFor(SKY_FACES * n, [&](int r) {
+        const int face = r / n;
+        const int y = r % n;
+        unsigned char* row = out.faces[face].mips[0].data() + (size_t)y * n * 4;
+        const float t = (y + 0.5f) / n;
+
+        for (int x = 0; x < n; ++x) {
+            float d[3];
+            SkyBox_FaceDirection(face, (x + 0.5f) / n, t, d);
+
+            // A espacio de la esfera original: p = M^T * d
+            float px = m[0][0] * d[0] + m[1][0] * d[1] + m[2][0] * d[2];
+            float py = m[0][1] * d[0] + m[1][1] * d[1] + m[2][1] * d[2];
+            float pz = m[0][2] * d[0] + m[1][2] * d[1] + m[2][2] * d[2];
+            float len = sqrtf(px * px + py * py + pz * pz);
+
+            // Parametrización de gluSphere: polos en ±z, s = theta / 2pi,
+            // t = 1 - rho / pi (con flipV la textura se invierte en v)
+            float rho = acosf(std::clamp(pz / len, -1.0f, 1.0f));
+            float theta = atan2f(-px, py);
+            if (theta < 0.0f) theta += 2.0f * (float)M_PI;
+
+            float u = theta / (2.0f * (float)M_PI);
+            float v = rho / (float)M_PI;
+            if (!orient.flipV) v = 1.0f - v;
+
+            SampleEquirect(src, w, h, u, v, row + x * 4);
+        }
+    });
+    stbi_image_free(src);
+
+    ParallelFor(SKY_FACES, [&](int face) { Texture_BuildMips(out.faces[face]); });
+    return true;
+}
@@ -0,0 +1,37 @@
+// skybox.h
+// Cielo pre-horneado: el panorama equirectangular se remuestrea una vez al
+// cargar el nivel en las seis caras de un cubo, que luego se dibuja con 12
+// triángulos en lugar de una esfera teselada.
+
+#pragma once
+
+#include "Textures.h"
+
+// Orientación del panorama (la misma que se aplicaba antes a la esfera de GLU)
+struct SkyOrientation {
+    float yawDeg = 0.0f;
+    float pitchDeg = 0.0f;
+    float rollDeg = 0.0f;
+    bool  flipV = true;
+};
+
+// Orden y convención de ejes de GL_TEXTURE_CUBE_MAP (+X, -X, +Y, -Y, +Z, -Z)
+enum SkyFace {
+    SKY_POS_X, SKY_NEG_X, SKY_POS_Y, SKY_NEG_Y, SKY_POS_Z, SKY_NEG_Z,
+    SKY_FACES
+};
+
+struct SkyFaces {
+    TextureImage faces[SKY_FACES];   // cuadradas, con mipmaps
+};
+
+// Decodifica el asset 'path' (ver AssetPack.h) y lo proyecta en las seis caras repartiendo las filas
+// entre varios hilos. No usa OpenGL.
+bool SkyBox_BakeFromEquirect(const char* path, const SkyOrientation& orient, SkyFaces& out);
+
+// Dirección (espacio de mundo) del punto (s, t) en [0,1]² de una cara;
+// t = 0 es la primera fila de la imagen.
+void SkyBox_FaceDirection(int face, float s, float t, float dir[3]);
+
+// Sufijo para registrar cada cara en la caché de texturas ("#px", ...)
+const char* SkyBox_FaceSuffix(int face);
@@ -0,0 +1,184 @@
+// texturediskcache.cpp
+// Formato .mip: MipFileHeader, la clave y, desde la siguiente frontera de
+// MIP_ALIGN, la cadena completa de niveles RGBA (cada uno también alineado).
+// Los desplazamientos salen del tamaño, así que no hace falta tabla.
+
+#include "TextureDiskCache.h"
+#include "AssetPack.h"
+#include "Hash.h"
+#include "MappedFile.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Subir al cambiar el formato o lo que se hornea (tamaño de las caras del
+// cielo, filtro de los mipmaps...): las entradas antiguas dejan de valer
+static const std::uint32_t MIP_CACHE_VERSION = 1;
+static const std::size_t MIP_ALIGN = 64;
+
+struct MipFileHeader {
+    char          magic[4];       // "MIPC"
+    std::uint32_t version;
+    std::uint64_t sourceSize;     // bytes del fichero de origen
+    std::int64_t  sourceTime;     // su fecha de modificación (reloj de ficheros)
+    std::uint64_t sourceHash;     // FNV-1a de su contenido
+    std::int32_t  width;
+    std::int32_t  height;
+    std::uint32_t levels;
+    std::uint32_t keySize;        // bytes de la clave tras la cabecera
+};
+
+static std::string g_Directory = "texcache";
+
+static std::size_t AlignUp(std::size_t n)
+{
+    return (n + MIP_ALIGN - 1) & ~(MIP_ALIGN - 1);
+}
+
+// Niveles hasta 1x1, como Texture_BuildMips()
+static int FullLevelCount(int width, int height)
+{
+    int levels = 1;
+    while (width > 1 || height > 1) {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        ++levels;
+    }
+    return levels;
+}
+
+static std::string EntryPath(const std::string& key)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.mip",
+        (unsigned long long)Hash_Fnv1a64(key.data(), key.size()));
+    return (fs::path(g_Directory) / name).string();
+}
+
+} // namespace
+
+void TextureDiskCache_SetDirectory(const std::string& dir)
+{
+    g_Directory = dir;
+}
+
+bool TextureDiskCache_Load(const std::string& key, const char* sourcePath, TextureImage& out)
+{
+    if (g_Directory.empty())
+        return false;
+    PROFILE_SCOPE("TextureDiskCache_Load");
+
+    AssetInfo src;
+    if (!Asset_Info(sourcePath, src))
+        return false;
+
+    auto file = std::make_shared<MappedFile>();
+    if (!file->Open(EntryPath(key).c_str()) || file->Size() < sizeof(MipFileHeader))
+        return false;
+
+    MipFileHeader h;
+    std::memcpy(&h, file->Data(), sizeof(h));
+    if (std::memcmp(h.magic, "MIPC", 4) != 0 || h.version != MIP_CACHE_VERSION)
+        return false;
+    if (h.width <= 0 || h.height <= 0 || h.levels != (std::uint32_t)FullLevelCount(h.width, h.height))
+        return false;
+    if (h.keySize != key.size() || file->Size() < sizeof(h) + key.size()
+        || std::memcmp(file->Data() + sizeof(h), key.data(), key.size()) != 0)
+        return false;
+
+    // Origen en el paquete: su hash viene en la tabla. Suelto con la misma
+    // fecha: vale sin leerlo. Otra fecha (copiado, tocado): vale si el
+    // contenido no ha cambiado.
+    std::uint64_t hash = 0;
+    if (h.sourceSize != src.size)
+        return false;
+    if (src.hashKnown) {
+        if (src.hash != h.sourceHash)
+            return false;
+    }
+    else if (h.sourceTime != src.time && (!Asset_Hash(sourcePath, hash) || hash != h.sourceHash))
+        return false;
+
+    std::vector<const unsigned char*> levels(h.levels);
+    std::size_t offset = AlignUp(sizeof(h) + key.size());
+    for (std::uint32_t i = 0; i < h.levels; ++i) {
+        const std::size_t bytes = Texture_LevelBytes(h.width, h.height, (int)i);
+        if (offset + bytes > file->Size())
+            return false;   // truncado
+        levels[i] = reinterpret_cast<const unsigned char*>(file->Data()) + offset;
+        offset = AlignUp(offset + bytes);
+    }
+
+    out = TextureImage();
+    out.width = h.width;
+    out.height = h.height;
+    out.mappedLevels = std::move(levels);
+    out.mapping = std::move(file);
+    return true;
+}
+
+void TextureDiskCache_Store(const std::string& key, const char* sourcePath, const TextureImage& img)
+{
+    if (g_Directory.empty() || !img.IsValid())
+        return;
+    PROFILE_SCOPE("TextureDiskCache_Store");
+
+    MipFileHeader h = {};
+    AssetInfo src;
+    if (!Asset_Info(sourcePath, src) || !Asset_Hash(sourcePath, h.sourceHash))
+        return;
+    std::memcpy(h.magic, "MIPC", 4);
+    h.version = MIP_CACHE_VERSION;
+    h.sourceSize = src.size;
+    h.sourceTime = src.time;
+    h.width = img.width;
+    h.height = img.height;
+    h.levels = (std::uint32_t)img.LevelCount();
+    h.keySize = (std::uint32_t)key.size();
+
+    std::error_code ec;
+    fs::create_directories(g_Directory, ec);
+
+    const std::string path = EntryPath(key);
+    const std::string tmp = path + ".tmp";
+    FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) {
+        std::cerr << "No se pudo escribir la caché de texturas: " << tmp << std::endl;
+        return;
+    }
+
+    static const unsigned char zeros[MIP_ALIGN] = {};
+    std::size_t offset = sizeof(h) + key.size();
+    std::fwrite(&h, sizeof(h), 1, f);
+    std::fwrite(key.data(), 1, key.size(), f);
+    for (int i = 0; i < img.LevelCount(); ++i) {
+        std::fwrite(zeros, 1, AlignUp(offset) - offset, f);
+        offset = AlignUp(offset);
+
+        const std::size_t bytes = Texture_LevelBytes(img.width, img.height, i);
+        std::fwrite(img.Level(i), 1, bytes, f);
+        offset += bytes;
+    }
+    const bool ok = !std::ferror(f);
+    if (std::fclose(f) != 0 || !ok) {
+        std::cerr << "No se pudo escribir la caché de texturas: " << tmp << std::endl;
+        fs::remove(tmp, ec);
+        return;
+    }
+
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        std::cerr << "No se pudo escribir la caché de texturas: " << path << std::endl;
+        fs::remove(tmp, ec);
+    }
+}
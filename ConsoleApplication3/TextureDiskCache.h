@@ -0,0 +1,30 @@
+// texturediskcache.h
+// Caché en disco de texturas ya decodificadas: todos los niveles RGBA de una
+// imagen en un fichero .mip proyectable, para no pasar por stb_image ni
+// generar mipmaps en cada arranque. Cada entrada guarda su clave y el tamaño,
+// la fecha y el hash del asset de origen (suelto o del paquete, ver
+// AssetPack.h); si el origen cambia, la entrada
+// deja de valer y se reescribe en la siguiente carga.
+//
+// Sin compresión S3TC/BPTC: el render es OpenGL 1.1 sin cargador de
+// extensiones (no hay glCompressedTexImage2D), así que se guarda RGBA tal
+// cual lo sube Texture_Upload().
+
+#pragma once
+
+#include "Textures.h"
+
+#include <string>
+
+// Directorio de la caché, relativo al de trabajo ("texcache" por defecto).
+// Vacío la desactiva. Llamar antes de cargar el primer nivel.
+void TextureDiskCache_SetDirectory(const std::string& dir);
+
+// Proyecta la entrada de 'key' si sigue valiendo para 'sourcePath'. Los
+// niveles de 'out' apuntan a la proyección, sin copias. Desde cualquier hilo.
+bool TextureDiskCache_Load(const std::string& key, const char* sourcePath, TextureImage& out);
+
+// Guarda todos los niveles de 'img' para 'key'. Escribe a un temporal y lo
+// renombra, así que un fallo a medias nunca deja una entrada rota. Desde
+// cualquier hilo, con claves distintas a la vez.
+void TextureDiskCache_Store(const std::string& key, const char* sourcePath, const TextureImage& img);
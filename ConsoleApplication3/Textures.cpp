@@ -0,0 +1,401 @@
+// textures.cpp
+// Decodificación con stb_image, reescalado a potencia de dos y mipmaps en CPU
+// (filtro de caja con SSE2 donde lo hay), repartidos por filas entre hilos.
+
+#include "Textures.h"
+#include "AssetPack.h"
+#include "Parallel.h"
+#include "Profiler.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TEXTURES_SSE2 1
+#else
+#define TEXTURES_SSE2 0
+#endif
+
+namespace {
+
+// Límite conservador para las tarjetas antiguas de los kioscos
+static const int MAX_TEXTURE_DIM = 4096;
+
+// Filas por tarea al reescalar o generar un mipmap; los niveles pequeños
+// se hacen en el hilo que llama
+static const int TEXTURE_ROWS_PER_TASK = 64;
+
+// Potencia de dos más cercana (misma regla que gluBuild2DMipmaps)
+static int NearestPow2(int n)
+{
+    int p = 1;
+    while (p * 2 <= n) p *= 2;
+    if (n - p > p * 2 - n) p *= 2;
+    return std::min(p, MAX_TEXTURE_DIM);
+}
+
+// Reescalado bilineal RGBA de las filas [y0, y1) de dst
+static void ResizeRGBA(const unsigned char* src, int sw, int sh,
+    unsigned char* dst, int dw, int dh, int y0, int y1)
+{
+    const float sx = (float)sw / dw;
+    const float sy = (float)sh / dh;
+
+    for (int y = y0; y < y1; ++y) {
+        float fy = (y + 0.5f) * sy - 0.5f;
+        int ya = std::max(0, (int)std::floor(fy));
+        int yb = std::min(sh - 1, ya + 1);
+        float ty = std::clamp(fy - ya, 0.0f, 1.0f);
+
+        for (int x = 0; x < dw; ++x) {
+            float fx = (x + 0.5f) * sx - 0.5f;
+            int xa = std::max(0, (int)std::floor(fx));
+            int xb = std::min(sw - 1, xa + 1);
+            float tx = std::clamp(fx - xa, 0.0f, 1.0f);
+
+            const unsigned char* p00 = src + ((size_t)ya * sw + xa) * 4;
+            const unsigned char* p10 = src + ((size_t)ya * sw + xb) * 4;
+            const unsigned char* p01 = src + ((size_t)yb * sw + xa) * 4;
+            const unsigned char* p11 = src + ((size_t)yb * sw + xb) * 4;
+            unsigned char* d = dst + ((size_t)y * dw + x) * 4;
+
+            for (int c = 0; c < 4; ++c) {
+                float top = p00[c] + (p10[c] - p00[c]) * tx;
+                float bot = p01[c] + (p11[c] - p01[c]) * tx;
+                d[c] = (unsigned char)(top + (bot - top) * ty + 0.5f);
+            }
+        }
+    }
+}
+
+// Una fila de salida del filtro de caja 2x2: cada texel es la media
+// redondeada de dos texels seguidos de r0 y los dos de debajo en r1
+static void DownsampleRowRGBA(const unsigned char* r0, const unsigned char* r1,
+    unsigned char* d, int dw)
+{
+    int x = 0;
+#if TEXTURES_SSE2
+    // Cuatro texels de salida por vuelta, con sumas en 16 bits (máx. 4 * 255)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi16(2);
+    for (; x + 4 <= dw; x += 4) {
+        const __m128i a0 = _mm_loadu_si128((const __m128i*)(r0 + 8 * x));
+        const __m128i a1 = _mm_loadu_si128((const __m128i*)(r0 + 8 * x + 16));
+        const __m128i b0 = _mm_loadu_si128((const __m128i*)(r1 + 8 * x));
+        const __m128i b1 = _mm_loadu_si128((const __m128i*)(r1 + 8 * x + 16));
+
+        // Sumas verticales: dos texels por registro
+        __m128i s01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+        __m128i s23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+        __m128i s45 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+        __m128i s67 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+        // Parejas horizontales en la mitad baja de cada registro
+        s01 = _mm_add_epi16(s01, _mm_srli_si128(s01, 8));
+        s23 = _mm_add_epi16(s23, _mm_srli_si128(s23, 8));
+        s45 = _mm_add_epi16(s45, _mm_srli_si128(s45, 8));
+        s67 = _mm_add_epi16(s67, _mm_srli_si128(s67, 8));
+
+        __m128i lo = _mm_unpacklo_epi64(s01, s23);
+        __m128i hi = _mm_unpacklo_epi64(s45, s67);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, two), 2);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, two), 2);
+        _mm_storeu_si128((__m128i*)(d + 4 * x), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; x < dw; ++x) {
+        const unsigned char* p = r0 + 8 * x;
+        const unsigned char* q = r1 + 8 * x;
+        for (int c = 0; c < 4; ++c)
+            d[4 * x + c] = (unsigned char)((p[c] + p[c + 4] + q[c] + q[c + 4] + 2) >> 2);
+    }
+}
+
+// Filas [y0, y1) del siguiente nivel de mipmap con filtro de caja 2x2 (o 2x1
+// / 1x2 en los bordes). Una sola fila de origen cuenta dos veces, igual que
+// antes; una sola columna va aparte.
+static void DownsampleRGBA(const unsigned char* src, int sw, int sh,
+    unsigned char* dst, int dw, int y0, int y1)
+{
+    const size_t rowBytes = (size_t)sw * 4;
+    for (int y = y0; y < y1; ++y) {
+        const unsigned char* r0 = src + (size_t)(sh > 1 ? 2 * y : y) * rowBytes;
+        const unsigned char* r1 = sh > 1 ? r0 + rowBytes : r0;
+        unsigned char* d = dst + (size_t)y * dw * 4;
+        if (sw > 1) {
+            DownsampleRowRGBA(r0, r1, d, dw);
+            continue;
+        }
+        for (int c = 0; c < 4; ++c)
+            d[c] = (unsigned char)((2 * (r0[c] + r1[c]) + 2) >> 2);
+    }
+}
+
+// Ejecuta fn(y0, y1) sobre bloques de filas, en paralelo si hay bastantes
+template <typename Fn>
+static void ForRowBlocks(int rows, const Fn& fn)
+{
+    const int blocks = (rows + TEXTURE_ROWS_PER_TASK - 1) / TEXTURE_ROWS_PER_TASK;
+    if (blocks <= 1) {
+        fn(0, rows);
+        return;
+    }
+    ParallelFor(blocks, [&](int b) {
+        fn(b * TEXTURE_ROWS_PER_TASK, std::min(rows, (b + 1) * TEXTURE_ROWS_PER_TASK));
+    });
+}
+
+} // namespace
+
+bool Texture_Decode(const char* path, TextureImage& out)
+{
+    PROFILE_SCOPE("Texture_Decode");
+    out = TextureImage();
+
+    // Directo de la proyección (paquete o fichero suelto), sin leerlo antes
+    AssetData asset;
+    if (!Asset_Open(path, asset))
+        return false;
+
+    int w, h, ch;
+    unsigned char* data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(asset.data),
+        (int)asset.size, &w, &h, &ch, 4);
+    if (!data)
+        return false;
+
+    int pw = NearestPow2(w);
+    int ph = NearestPow2(h);
+
+    out.width = pw;
+    out.height = ph;
+    out.mips.emplace_back((size_t)pw * ph * 4);
+    if (pw == w && ph == h) {
+        std::copy(data, data + (size_t)w * h * 4, out.mips[0].begin());
+    }
+    else {
+        ForRowBlocks(ph, [&](int y0, int y1) {
+            ResizeRGBA(data, w, h, out.mips[0].data(), pw, ph, y0, y1);
+        });
+    }
+    stbi_image_free(data);
+
+    Texture_BuildMips(out);
+    return true;
+}
+
+void Texture_BuildMips(TextureImage& img)
+{
+    PROFILE_SCOPE("Texture_BuildMips");
+    if (img.mips.empty())
+        return;
+    img.mips.resize(1);
+
+    int pw = img.width, ph = img.height;
+    while (pw > 1 || ph > 1) {
+        int nw = std::max(1, pw / 2);
+        int nh = std::max(1, ph / 2);
+        std::vector<unsigned char> next((size_t)nw * nh * 4);
+        const unsigned char* src = img.mips.back().data();
+        ForRowBlocks(nh, [&](int y0, int y1) {
+            DownsampleRGBA(src, pw, ph, next.data(), nw, y0, y1);
+        });
+        img.mips.push_back(std::move(next));
+        pw = nw;
+        ph = nh;
+    }
+}
+
+std::size_t Texture_LevelBytes(int width, int height, int level)
+{
+    return (std::size_t)std::max(1, width >> level) * std::max(1, height >> level) * 4;
+}
+
+GLuint Texture_Upload(const TextureImage& img, GLint wrapS, GLint wrapT)
+{
+    PROFILE_SCOPE("Texture_Upload");
+    if (!img.IsValid())
+        return 0;
+
+    GLuint id;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D, id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapS);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapT);
+
+    GLint prevAlign = 4;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &prevAlign);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    int w = img.width, h = img.height;
+    for (int level = 0; level < img.LevelCount(); ++level) {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, w, h, 0,
+            GL_RGBA, GL_UNSIGNED_BYTE, img.Level(level));
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, prevAlign);
+    return id;
+}
+
+// -----------------------------------------------------------------------------
+// Caché de texturas
+// -----------------------------------------------------------------------------
+
+namespace {
+
+struct CacheEntry {
+    GLuint      id = 0;
+    std::size_t bytes = 0;
+    int         refs = 0;
+    unsigned    lastUse = 0;
+};
+
+// Protege el mapa y los contadores; las llamadas a GL se hacen fuera o
+// siempre desde el hilo de GL.
+static std::mutex g_CacheMutex;
+static std::unordered_map<std::string, CacheEntry> g_Cache;
+static std::size_t g_CacheBytes = 0;
+static std::size_t g_CacheBudget = 256u * 1024u * 1024u;
+static unsigned g_CacheClock = 0;
+static TextureCacheStats g_CacheCounters;
+
+static std::size_t EstimateVram(const TextureImage& img)
+{
+    std::size_t bytes = 0;
+    for (int level = 0; level < img.LevelCount(); ++level)
+        bytes += Texture_LevelBytes(img.width, img.height, level);
+    return bytes;
+}
+
+// Desaloja entradas sin referencias (LRU) hasta cumplir el presupuesto.
+// Llamar con g_CacheMutex tomado; devuelve los ids a borrar en GL.
+static std::vector<GLuint> CollectEvictions()
+{
+    std::vector<GLuint> freed;
+    while (g_CacheBytes > g_CacheBudget) {
+        auto victim = g_Cache.end();
+        for (auto it = g_Cache.begin(); it != g_Cache.end(); ++it) {
+            if (it->second.refs > 0) continue;
+            if (victim == g_Cache.end() || it->second.lastUse < victim->second.lastUse)
+                victim = it;
+        }
+        if (victim == g_Cache.end())
+            break;   // todo lo residente está en uso
+
+        g_CacheBytes -= victim->second.bytes;
+        freed.push_back(victim->second.id);
+        g_Cache.erase(victim);
+        ++g_CacheCounters.evictions;
+    }
+    return freed;
+}
+
+static void DeleteTextures(const std::vector<GLuint>& ids)
+{
+    if (!ids.empty())
+        glDeleteTextures((GLsizei)ids.size(), ids.data());
+}
+
+} // namespace
+
+GLuint TextureCache_Acquire(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(g_CacheMutex);
+    auto it = g_Cache.find(path);
+    if (it == g_Cache.end()) {
+        ++g_CacheCounters.misses;
+        return 0;
+    }
+    ++it->second.refs;
+    it->second.lastUse = ++g_CacheClock;
+    ++g_CacheCounters.hits;
+    return it->second.id;
+}
+
+GLuint TextureCache_Insert(const std::string& path, const TextureImage& img,
+    GLint wrapS, GLint wrapT)
+{
+    if (!img.IsValid())
+        return 0;
+
+    // Otra carga pudo subirla mientras tanto
+    {
+        std::lock_guard<std::mutex> lock(g_CacheMutex);
+        auto it = g_Cache.find(path);
+        if (it != g_Cache.end()) {
+            ++it->second.refs;
+            it->second.lastUse = ++g_CacheClock;
+            return it->second.id;
+        }
+    }
+
+    GLuint id = Texture_Upload(img, wrapS, wrapT);
+    if (!id)
+        return 0;
+
+    std::vector<GLuint> freed;
+    {
+        std::lock_guard<std::mutex> lock(g_CacheMutex);
+        CacheEntry& e = g_Cache[path];
+        e.id = id;
+        e.bytes = EstimateVram(img);
+        e.refs = 1;
+        e.lastUse = ++g_CacheClock;
+        g_CacheBytes += e.bytes;
+        freed = CollectEvictions();
+    }
+    DeleteTextures(freed);
+    return id;
+}
+
+void TextureCache_Release(GLuint id)
+{
+    if (!id)
+        return;
+
+    std::vector<GLuint> freed;
+    {
+        std::lock_guard<std::mutex> lock(g_CacheMutex);
+        for (auto& kv : g_Cache) {
+            if (kv.second.id == id) {
+                if (kv.second.refs > 0) --kv.second.refs;
+                break;
+            }
+        }
+        freed = CollectEvictions();
+    }
+    DeleteTextures(freed);
+}
+
+void TextureCache_SetBudget(std::size_t bytes)
+{
+    std::vector<GLuint> freed;
+    {
+        std::lock_guard<std::mutex> lock(g_CacheMutex);
+        g_CacheBudget = bytes;
+        freed = CollectEvictions();
+    }
+    DeleteTextures(freed);
+}
+
+TextureCacheStats TextureCache_GetStats()
+{
+    std::lock_guard<std::mutex> lock(g_CacheMutex);
+    TextureCacheStats s = g_CacheCounters;
+    s.textures = (int)g_Cache.size();
+    s.referenced = 0;
+    for (const auto& kv : g_Cache)
+        if (kv.second.refs > 0) ++s.referenced;
+    s.bytes = g_CacheBytes;
+    s.budget = g_CacheBudget;
+    return s;
+}
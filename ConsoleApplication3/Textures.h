@@ -0,0 +1,78 @@
+// textures.h
+// Carga de texturas en dos fases: decodificación + mipmaps en CPU (cualquier
+// hilo) y subida a OpenGL (hilo de GL).
+
+#pragma once
+
+#include <GL/glut.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+class MappedFile;
+
+// Imagen RGBA con tamaño potencia de dos y su cadena completa de mipmaps.
+// RGBA y no RGB: es lo que guarda el driver de todos modos (la subida no
+// convierte) y el filtro de caja va de cuatro en cuatro bytes.
+struct TextureImage {
+    int width = 0;
+    int height = 0;
+    std::vector<std::vector<unsigned char>> mips;   // mips[0] = nivel base
+
+    // En vez de 'mips': niveles leídos de la caché en disco, apuntando
+    // directamente a su proyección (ver TextureDiskCache.h)
+    std::shared_ptr<const MappedFile> mapping;
+    std::vector<const unsigned char*> mappedLevels;
+
+    int LevelCount() const { return mapping ? (int)mappedLevels.size() : (int)mips.size(); }
+    const unsigned char* Level(int i) const { return mapping ? mappedLevels[i] : mips[i].data(); }
+    bool IsValid() const { return LevelCount() > 0; }
+};
+
+// Bytes RGBA del nivel 'level' de una imagen width x height
+std::size_t Texture_LevelBytes(int width, int height, int level);
+
+// Decodifica el asset 'path' (ver AssetPack.h), lo reescala a potencia de dos (como gluBuild2DMipmaps)
+// y genera los mipmaps con filtro de caja. No usa OpenGL; reparte las filas
+// con ParallelFor.
+bool Texture_Decode(const char* path, TextureImage& out);
+
+// Rellena mips[1..] a partir de mips[0] (width x height, potencia de dos).
+void Texture_BuildMips(TextureImage& img);
+
+// Sube todos los niveles con glTexImage2D. Devuelve 0 si la imagen no es válida.
+GLuint Texture_Upload(const TextureImage& img, GLint wrapS, GLint wrapT);
+
+// -----------------------------------------------------------------------------
+// Caché de texturas por ruta con recuento de referencias
+// -----------------------------------------------------------------------------
+// Las texturas sin referencias siguen en GPU (volver a un nivel ya visto no
+// decodifica nada) hasta que el total supera el presupuesto de VRAM; entonces
+// se liberan las menos usadas recientemente.
+
+struct TextureCacheStats {
+    int         textures = 0;      // residentes en GPU
+    int         referenced = 0;    // con al menos una referencia
+    std::size_t bytes = 0;         // VRAM estimada
+    std::size_t budget = 0;
+    int         hits = 0;
+    int         misses = 0;
+    int         evictions = 0;
+};
+
+// Si 'path' ya está en GPU suma una referencia y devuelve su id; si no, 0.
+// Se puede llamar desde cualquier hilo (no toca OpenGL).
+GLuint TextureCache_Acquire(const std::string& path);
+
+// Sube 'img' y la registra con una referencia (hilo de GL). Si otra carga
+// ya la había subido, reutiliza esa. Devuelve 0 si la imagen no es válida.
+GLuint TextureCache_Insert(const std::string& path, const TextureImage& img,
+    GLint wrapS, GLint wrapT);
+
+// Quita una referencia (hilo de GL). Puede provocar desalojos.
+void TextureCache_Release(GLuint id);
+
+void TextureCache_SetBudget(std::size_t bytes);
+TextureCacheStats TextureCache_GetStats();
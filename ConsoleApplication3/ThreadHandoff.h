@@ -0,0 +1,79 @@
+// threadhandoff.h
+// Paso de datos entre el hilo de simulación y el de render sin bloqueos:
+// triple búfer para la última instantánea del mundo y cola de un productor /
+// un consumidor para eventos.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// -----------------------------------------------------------------------------
+// TripleBuffer: el escritor rellena su copia y la publica; el lector se queda
+// siempre con la más reciente sin esperar al escritor ni frenarlo.
+// -----------------------------------------------------------------------------
+template <typename T>
+class TripleBuffer {
+public:
+    // Copia que puede rellenar el escritor (solo su hilo)
+    T& WriteSlot() { return m_Slots[m_Write]; }
+
+    // Entrega WriteSlot() al lector y toma la copia que este haya soltado
+    void Publish()
+    {
+        m_Write = m_Middle.exchange(m_Write | DIRTY, std::memory_order_acq_rel) & INDEX;
+    }
+
+    // Última copia publicada (solo el hilo lector)
+    const T& Read()
+    {
+        if (m_Middle.load(std::memory_order_relaxed) & DIRTY)
+            m_Read = m_Middle.exchange(m_Read, std::memory_order_acq_rel) & INDEX;
+        return m_Slots[m_Read];
+    }
+
+private:
+    static const int INDEX = 3;
+    static const int DIRTY = 4;   // hay una copia nueva en m_Middle
+
+    T m_Slots[3] = {};
+    int m_Write = 0;
+    int m_Read = 1;
+    std::atomic<int> m_Middle{ 2 };
+};
+
+// -----------------------------------------------------------------------------
+// SpscQueue: cola circular de capacidad fija (potencia de dos) para un único
+// hilo productor y un único hilo consumidor.
+// -----------------------------------------------------------------------------
+template <typename T, std::size_t N>
+class SpscQueue {
+    static_assert((N & (N - 1)) == 0, "N debe ser potencia de dos");
+
+public:
+    // false si está llena (el evento se pierde)
+    bool Push(const T& item)
+    {
+        std::size_t head = m_Head.load(std::memory_order_relaxed);
+        if (head - m_Tail.load(std::memory_order_acquire) == N)
+            return false;
+        m_Items[head & (N - 1)] = item;
+        m_Head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Pop(T& item)
+    {
+        std::size_t tail = m_Tail.load(std::memory_order_relaxed);
+        if (tail == m_Head.load(std::memory_order_acquire))
+            return false;
+        item = m_Items[tail & (N - 1)];
+        m_Tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T m_Items[N] = {};
+    alignas(64) std::atomic<std::size_t> m_Head{ 0 };   // lo escribe el productor
+    alignas(64) std::atomic<std::size_t> m_Tail{ 0 };   // lo escribe el consumidor
+};
@@ -13,8 +13,28 @@
 #include <iostream>
 #include <algorithm>
 #include <cstdlib>
+#include <cfloat>
+#include <cstdint>
 
 #include <string>   
+#include <memory>
+#include <future>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+#include "LevelFile.h"
+#include "Parallel.h"
+#include "Profiler.h"
+#include "RectCover.h"
+#include "SkyBox.h"
+#include "TextureDiskCache.h"
+#include "Textures.h"
+#include "ThreadHandoff.h"
+#include "WorldBench.h"
 
 // Comunicación con el sistema de puzzles (definido en puzzles.cpp)
 extern void Puzzles_OpenForPrism(int prismIndex);
@@ -26,6 +46,20 @@ extern void Puzzles_Init(int numPrisms);
 
 static float camX = 1.5f, camY = 1.62f, camZ = 1.5f;
 static float yaw = 0.0f, pitch = 0.0f;
+
+// La física avanza en pasos fijos; para dibujar se interpola entre la
+// posición al inicio del último paso (prevCam*) y la actual (cam*) según el
+// tiempo pasado desde que se publicó. El ratón (yaw/pitch) va sin interpolar.
+static float prevCamX = 1.5f, prevCamY = 1.62f, prevCamZ = 1.5f;
+static float renderCamX = 1.5f, renderCamY = 1.62f, renderCamZ = 1.5f;
+static float g_RenderAlpha = 1.0f;
+
+// Tras un teletransporte (spawn, respawn) no hay nada que interpolar
+static inline void snapCameraInterpolation() {
+    prevCamX = camX;
+    prevCamY = camY;
+    prevCamZ = camZ;
+}
 static float baseSpeed = 3.0f, mouseSens = 0.0028f;
 static float gravity = 18.0f, jumpVel = 6.8f, velY = 0.0f;
 static bool onGround = true;
@@ -40,6 +74,12 @@ static const float SPRINT_MULT = 2.8f;
 
 static int  winW = 1600, winH = 900;
 
+// Perspectiva (World_OnResize) y frustum de descarte (setCamera)
+static const float CAMERA_FOV_Y = 70.0f;
+static const float CAMERA_NEAR = 0.05f;
+static const float CAMERA_FAR = 400.0f;
+static float g_CameraAspect = 1600.0f / 900.0f;
+
 static bool isFullscreen = false;
 // Flag de pausa global
 static bool g_Paused = false;
@@ -81,12 +121,127 @@ static const float TRANSITION_TOTAL = 2.0f; // 2 segundo para cada fase
 
 static LevelDifficulty g_TransitionTargetLevel = LevelDifficulty::EASY;
 
+// -----------------------------------------------------------------------------
+// Hilo de simulación y hilo de render
+// -----------------------------------------------------------------------------
+// La simulación (movimiento, colisiones, disparadores, transiciones) corre en
+// su propio hilo a paso fijo y al final de cada paso publica una WorldState;
+// el render (hilo de GLUT) dibuja la última publicada. Lo que entra a la
+// simulación (teclas, ratón, avisos de los puzzles) va por g_SimInputs y lo
+// que la simulación pide al render (abrir un puzzle, subir o activar un
+// nivel: ImGui y GL) por g_SimCommands. Sin hilo (WorldBench) todo corre
+// igual en uno solo.
+//
+// Propiedad: cam*, yaw/pitch, teclas, pausa, sprint y transición son de la
+// simulación; nivel activo, texturas, narrador, vidas y puzzles, del render.
+// g_Level, greenPrisms y el spawn solo cambian en el render mientras la
+// simulación espera LEVEL_COMMITTED, así que no hacen falta más cerrojos.
+
+struct WorldState {
+    float prevCamX, prevCamY, prevCamZ;
+    float camX, camY, camZ;
+    float yaw, pitch;
+    bool  paused;
+    TransitionState transition;
+    float transitionTime;
+    unsigned inputsApplied;   // eventos de g_SimInputs ya aplicados
+    std::chrono::steady_clock::time_point stepTime;
+
+    // Acumulados de World_Update(): la ventana del perfilador solo ve el
+    // hilo principal, así que su tiempo llega al render por aquí
+    unsigned simSteps;
+    double   simBusyMs;
+};
+
+// Render -> simulación
+struct WorldInput {
+    enum Type : unsigned char {
+        KEY_DOWN,          // a = tecla, b = ms de GLUT
+        KEY_UP,            // a = tecla
+        MOUSE_LOOK,        // a, b = desplazamiento en píxeles
+        PUZZLE_CLOSED,
+        PRISM_DISABLED,    // a = índice
+        PUZZLE_PENALTY,    // a = 1 si además se invierten los controles
+        LOAD_LEVEL,        // a = LevelDifficulty (F1/F2/F3)
+        LEVEL_READY,       // nivel pendiente ya subido a GL
+        LEVEL_COMMITTED    // nivel activado: respawn / seguir
+    };
+    Type type;
+    int  a, b;
+};
+
+// Simulación -> render
+struct WorldCommand {
+    enum Type : unsigned char {
+        OPEN_PUZZLE,       // arg = índice del prisma
+        START_LEVEL_LOAD,  // arg = LevelDifficulty
+        COMMIT_LEVEL,
+        LOAD_LEVEL_NOW     // arg = LevelDifficulty
+    };
+    Type type;
+    int  arg;
+};
+
+static const float SIM_STEP_S = 1.0f / 120.0f;
+static const float SIM_MAX_LAG_S = 0.25f;   // tras un parón no se intenta recuperar más
+
+static TripleBuffer<WorldState> g_Snapshots;
+static SpscQueue<WorldInput, 1024> g_SimInputs;
+static SpscQueue<WorldCommand, 64> g_SimCommands;
 
+static std::thread g_SimThread;
+static std::atomic<bool> g_SimRunning{ false };
 
+// Solo simulación
+static unsigned g_InputsApplied = 0;
+static unsigned g_SimSteps = 0;
+static double g_SimBusyMs = 0.0;
+static bool g_SimPuzzleOpen = false;       // hasta PUZZLE_CLOSED
+static bool g_SimAwaitingLevel = false;    // esperando LEVEL_COMMITTED
+static bool g_SimLevelReady = false;
+static std::vector<bool> g_SimPrismActive;
 
+// Solo render
+static WorldState g_View;                  // instantánea del frame en curso
+static unsigned g_InputsPushed = 0;
+static bool g_PuzzleShown = false;
+static bool g_PendingLevelUploaded = false;
 
+static void pushSimInput(WorldInput::Type type, int a = 0, int b = 0)
+{
+    if (!g_SimInputs.Push({ type, a, b })) {
+        std::cerr << "Cola de entrada de la simulación llena, evento perdido" << std::endl;
+        return;
+    }
+    ++g_InputsPushed;
+}
 
+static void pushSimCommand(WorldCommand::Type type, int arg = 0)
+{
+    if (!g_SimCommands.Push({ type, arg }))
+        std::cerr << "Cola de órdenes al render llena, orden perdida" << std::endl;
+}
 
+static void publishWorldState()
+{
+    WorldState& s = g_Snapshots.WriteSlot();
+    s.prevCamX = prevCamX;
+    s.prevCamY = prevCamY;
+    s.prevCamZ = prevCamZ;
+    s.camX = camX;
+    s.camY = camY;
+    s.camZ = camZ;
+    s.yaw = yaw;
+    s.pitch = pitch;
+    s.paused = g_Paused;
+    s.transition = g_TransitionState;
+    s.transitionTime = g_TransitionTime;
+    s.inputsApplied = g_InputsApplied;
+    s.stepTime = std::chrono::steady_clock::now();
+    s.simSteps = g_SimSteps;
+    s.simBusyMs = g_SimBusyMs;
+    g_Snapshots.Publish();
+}
 
 // RNG para frases random
 static std::mt19937 g_SrxRng{ std::random_device{}() };
@@ -99,24 +254,28 @@ static std::mt19937 g_SrxRng{ std::random_device{}() };
 // Mundo / laberinto
 // -----------------------------------------------------------------------------
 
-static const float CELL = 2.7f;
-static const float wallH = 8.0f;
+static constexpr float CELL = 2.7f;
+static constexpr float wallH = 8.0f;
+
+// Trozos de la malla de muros para el descarte por frustum
+static const int   CHUNK_CELLS = 4;
+static const float CHUNK_SIZE = CHUNK_CELLS * CELL;
 
 // Sky
-static float skyYawDeg = 0.0f;
-static float skyPitchDeg = 0.0f;
-static float skyRollDeg = 0.0f;
-static bool  skyFlipV = true;
-static const float SKYDOME_RAD = 250.0f;
+static SkyOrientation skyOrient;
+static const float SKYBOX_HALF = 100.0f;   // esquinas a ~173, dentro del zFar
 
 // Texturas
 GLuint texFloor = 0;
 static const float FLOOR_UV_PER_UNIT = 0.5f;
 
-GLuint texSkyEquirect = 0;
+GLuint texSky[SKY_FACES] = {};
 GLuint texWall = 0;
 static const float UV_SCALE = 1.0f;
 
+// Presupuesto de VRAM para la caché de texturas (ver TextureCache_*)
+static const std::size_t TEXTURE_VRAM_BUDGET_MB = 192;
+
 // 0 = normal
 // 1 = muros sin textura, grises
 // 2 = cielo rojo, muros y suelo negros
@@ -124,13 +283,39 @@ static const float UV_SCALE = 1.0f;
 // 4 = solo queda el portal flotando en el vacio negro
 static int g_WorldStage = 0;
 
+// -----------------------------------------------------------------------------
+// Tiempos por fase de World_Render (ver WorldBench.h)
+// -----------------------------------------------------------------------------
+
+static bool g_PhaseTiming = false;
+static bool g_PhaseSyncGL = false;
+static double g_PhaseMs[RENDER_PHASE_COUNT] = {};
+static int g_PhaseCurrent = -1;
+static std::chrono::steady_clock::time_point g_PhaseStart;
+
+// Modo benchmark: sin disparadores de puzzle ni portal
+static bool g_BenchmarkMode = false;
+
+// Cierra la fase en curso y abre 'next' (RenderPhase::Count = fin del frame).
+// Sin medición ni captura de traza activas no hace nada.
+static void markPhase(RenderPhase next) {
+    if (!g_PhaseTiming && !Profiler_IsCapturing())
+        return;
+    if (g_PhaseTiming && g_PhaseSyncGL)
+        glFinish();
+
+    auto now = std::chrono::steady_clock::now();
+    if (g_PhaseCurrent >= 0) {
+        g_PhaseMs[g_PhaseCurrent] += std::chrono::duration<double, std::milli>(now - g_PhaseStart).count();
+        Profiler_TraceComplete(RenderPhase_Name((RenderPhase)g_PhaseCurrent), g_PhaseStart, now);
+    }
+    g_PhaseCurrent = (next == RenderPhase::Count) ? -1 : (int)next;
+    g_PhaseStart = now;
+}
+
 // Quadrics reutilizables
-GLUquadric* gQuadricSky = nullptr;
 GLUquadric* gQuadricSphere = nullptr;
 
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -143,15 +328,15 @@ static inline float clampf(float v, float a, float b) {
 // Mapa del laberinto
 // -----------------------------------------------------------------------------
 
+// Laberintos integrados: se usan si no se encuentra el fichero levels/*.lvl
 #define USE_EXAMPLE_A
 
 #ifdef USE_EXAMPLE_A
 static const int MAP_W = 7;
 static const int MAP_H = 35;
-static int maze[MAP_H][MAP_W];
 
 // 1 = muro, 0 = espacio (pasillo central en la columna 3)
-static int mazeHard[MAP_H][MAP_W] = {
+static constexpr int mazeHard[MAP_H][MAP_W] = {
     {1,1,1,0,1,1,1}, // 0
     {1,1,1,0,1,1,1}, // 1
     {1,1,1,0,1,1,1}, // 2
@@ -189,7 +374,7 @@ static int mazeHard[MAP_H][MAP_W] = {
     {1,1,1,0,1,1,1}  // 34
 };
 #endif
-static const int mazeEasy[MAP_H][MAP_W] = {
+static constexpr int mazeEasy[MAP_H][MAP_W] = {
  //  0 1 2 3 4 5 6
     {1,1,1,0,1,1,1}, // 0
     {1,1,1,0,1,1,1}, // 1
@@ -228,7 +413,7 @@ static const int mazeEasy[MAP_H][MAP_W] = {
     {1,1,1,0,1,1,1}  // 34
 };
 
-static const int mazeMedium[MAP_H][MAP_W] = {
+static constexpr int mazeMedium[MAP_H][MAP_W] = {
  //  0 1 2 3 4 5 6
     {1,1,1,0,1,1,1}, // 0
     {1,0,0,0,0,0,1}, // 1
@@ -266,25 +451,126 @@ static const int mazeMedium[MAP_H][MAP_W] = {
     {1,1,1,0,0,0,1}, // 33 
     {1,1,1,0,1,1,1}  // 34
 };
-struct CellCoord {
-    int x; // columna
-    int z; // fila
-};
-
 struct AABB {
     float minx, miny, minz;
     float maxx, maxy, maxz;
 };
 
-struct Rect {
-    int x, z, w, l;
+using Rect = CellRect;
+
+// Vértice intercalado con el layout de glInterleavedArrays(GL_T2F_N3F_V3F)
+struct LevelVertex {
+    float u, v;
+    float nx, ny, nz;
+    float x, y, z;
+};
+
+// Trozo de la malla de muros: cajas cuyo centro cae en un cuadrado de
+// CHUNK_CELLS x CHUNK_CELLS celdas, contiguas en wallVerts / edgeVerts
+struct LevelChunk {
+    AABB bounds;          // unión de sus cajas (puede salirse del cuadrado)
+    int firstVert = 0, vertCount = 0;
+    int firstEdge = 0, edgeCount = 0;   // en vértices de edgeVerts (xyz)
+    bool exterior = false;              // tiene cajas fuera del laberinto
+};
+
+// Palabra no nula del bitset de trozos visibles: bits de los trozos
+// 64 * index .. 64 * index + 63
+struct PvsWord {
+    uint32_t index;
+    uint64_t bits;
+};
+
+static const uint32_t PVS_NONE = 0xFFFFFFFFu;
+
+// Broadphase de colisiones (ver buildCollisionGrid): índices de muros por
+// celda CELL x CELL en formato compacto
+struct CollisionGrid {
+    int x0 = 0, z0 = 0;     // celda mínima en coordenadas de rejilla
+    int w = 0, h = 0;       // tamaño de la rejilla en celdas
+    std::vector<int> cellStart;
+    std::vector<int> cellWalls;
+};
+
+// Geometría completa de un nivel. Se construye sin tocar OpenGL (puede
+// hacerse en el hilo de carga); solo uploadLevelMesh() necesita contexto GL.
+struct LevelGeometry {
+    // Laberinto de tamaño dinámico (cargado desde fichero o integrado)
+    int mapW = MAP_W;
+    int mapH = MAP_H;
+    BitGrid maze;                   // bit a 1 = muro; maze.Get(x, z)
+
+    // Laberinto grande: sus muros no están en wallRects / walls / chunks
+    // sino en trozos que se cargan alrededor de la cámara (ver updateStreaming)
+    bool streamed = false;
+
+    std::vector<Rect> wallRects;    // muros del laberinto (ver mergeWallRects)
+    std::vector<AABB> walls;        // colisión: laberinto + foyer + sala final
+    std::vector<AABB> extraWalls;   // render: foyer, pasillo y sala final
+    CollisionGrid coll;             // broadphase de 'walls'
+
+    // Malla estática horneada (ver bakeLevelMesh)
+    std::vector<LevelVertex> wallVerts;   // quads de todos los muros
+    std::vector<float>       edgeVerts;   // contorno superior (GL_LINES, xyz)
+    std::vector<LevelChunk>  chunks;      // para descartar fuera del frustum
+    std::vector<int>         cellChunk;   // trozo de cada celda muro, -1 si libre
+    std::vector<int>         exteriorChunks;   // foyer, sala final, decorado
+
+    // PVS (ver buildPvs): conjunto de trozos visibles desde cada celda libre.
+    // Las celdas seguidas con el mismo conjunto lo comparten.
+    std::vector<uint32_t> pvsCellSet;     // mapW*mapH, PVS_NONE en muros
+    std::vector<uint32_t> pvsSetStart;    // conjunto i = pvsWords[start[i], start[i+1])
+    std::vector<PvsWord>  pvsWords;
+    GLuint wallList = 0;                  // 2 display lists por trozo: muros y contorno
+    GLsizei listCount = 0;
 };
 
 std::vector<AABB> decorWalls;
 std::vector<AABB> hiddenWalls;
-std::vector<AABB> walls;
-std::vector<Rect> wallRects;
-std::vector<AABB> extraWalls;
+
+// Nivel ACTIVO
+static LevelGeometry g_Level;
+
+// -----------------------------------------------------------------------------
+// Trozos de laberintos grandes (ver updateStreaming)
+// -----------------------------------------------------------------------------
+
+// Laberintos desde este número de celdas van por trozos
+static const size_t STREAM_MIN_CELLS = 256 * 256;
+
+static int    g_StreamRadius = 3;                 // en trozos alrededor de la cámara
+static size_t g_StreamBudgetBytes = 32u << 20;    // malla + colisión residentes
+
+// Cajas y rejilla de colisión de un trozo. El render las publica con
+// std::atomic_store y la simulación las lee con std::atomic_load.
+struct StreamCollision {
+    std::vector<AABB> walls;
+    CollisionGrid grid;
+};
+
+enum class StreamState : unsigned char { Unloaded, Queued, Resident };
+
+struct StreamChunk {
+    StreamState state = StreamState::Unloaded;
+    AABB bounds{};                      // unión de sus partes
+    std::vector<LevelChunk> parts;      // para el frustum (vértices ya en GL)
+    GLuint lists = 0;                   // 2 display lists por parte
+    size_t bytes = 0;                   // malla + colisión
+    std::shared_ptr<const StreamCollision> collision;
+};
+
+// La tabla de trozos solo cambia al activar un nivel, con la simulación
+// esperando (ver resetStreaming)
+struct StreamWorld {
+    int chunksX = 0, chunksZ = 0;
+    std::vector<StreamChunk> chunks;
+    std::vector<int> live;                  // trozos en cola o residentes
+    std::shared_ptr<const BitGrid> maze;    // copia para el hilo de horneado
+    unsigned generation = 0;                // distingue trozos de niveles anteriores
+    int camChunk = -1;                      // trozo de la cámara en el último frame
+    StreamStats stats;
+};
+static StreamWorld g_Stream;
 
 // prismas verdes (triggers de puzzles)
 static std::vector<CellCoord> greenPrismsHard = {
@@ -319,6 +605,7 @@ static std::vector<CellCoord> greenPrismsMedium = {
 // Conjunto ACTIVO de rombos para el nivel actual
 static std::vector<CellCoord> greenPrisms;
 static std::vector<bool> greenPrismActive;
+static bool g_PrismBatchDirty = true;   // rehacer el lote de prismas al dibujar
 bool gHasSkyTexture = false;
 
 // “foyer” + pasillo
@@ -326,7 +613,9 @@ static const float START_W = 6.0f * CELL;
 static const float START_D = 4.0f * CELL;
 static const float CORRIDOR_W = 1.5f * CELL;
 
-static inline float ENTRANCE_CX() { return ((MAP_W / 2) + 0.5f) * CELL; }
+static inline float ENTRANCE_CX(int mapW) { return ((mapW / 2) + 0.5f) * CELL; }
+static inline float ENTRANCE_CX() { return ENTRANCE_CX(g_Level.mapW); }
+static inline float START_CX(int mapW) { return ENTRANCE_CX(mapW); }
 static inline float START_CX() { return ENTRANCE_CX(); }
 static inline float START_CZ() { return -8.0f * CELL; }
 
@@ -403,59 +692,13 @@ static void SetupSrxWelcomeForCurrentLevel()
 
 
 
-// -----------------------------------------------------------------------------
-// Carga de texturas
-// -----------------------------------------------------------------------------
-
-GLuint loadTextureSTB(const char* filename) {
-    int w, h, ch;
-    unsigned char* data = stbi_load(filename, &w, &h, &ch, 3);
-    if (!data) {
-        std::cerr << "Error cargando textura: " << filename << std::endl;
-        return 0;
-    }
-    GLuint id;
-    glGenTextures(1, &id);
-    glBindTexture(GL_TEXTURE_2D, id);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGB, w, h, GL_RGB, GL_UNSIGNED_BYTE, data);
-    stbi_image_free(data);
-    return id;
-}
-
-GLuint loadTextureEquirect(const char* filename) {
-    int w, h, ch;
-    unsigned char* data = stbi_load(filename, &w, &h, &ch, 3);
-    if (!data) {
-        std::cerr << "Error cargando panorama: " << filename << std::endl;
-        gHasSkyTexture = false;
-        return 0;
-    }
-
-    GLuint id;
-    glGenTextures(1, &id);
-    glBindTexture(GL_TEXTURE_2D, id);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);        // 360°
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE); // polos
-    gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGB, w, h, GL_RGB, GL_UNSIGNED_BYTE, data);
-    stbi_image_free(data);
-
-    gHasSkyTexture = true;
-    return id;
-}
-
 // -----------------------------------------------------------------------------
 // Construcción de la sala final, foyer, etc.
 // -----------------------------------------------------------------------------
 
-void buildEndRoom() {
-    const float centerX = ENTRANCE_CX();
-    const float labEndZ = MAP_H * CELL;
+void buildEndRoom(LevelGeometry& geo) {
+    const float centerX = ENTRANCE_CX(geo.mapW);
+    const float labEndZ = geo.mapH * CELL;
 
     const float roomW = 4.0f * CELL;
     const float roomD = 3.0f * CELL;
@@ -477,8 +720,8 @@ void buildEndRoom() {
     auto addWall = [&](float x0, float y0, float z0,
         float x1, float y1, float z1) {
             AABB a = MakeAABB(x0, y0, z0, x1, y1, z1);
-            walls.emplace_back(a);       // colisión
-            extraWalls.emplace_back(a);  // render
+            geo.walls.emplace_back(a);       // colisión
+            geo.extraWalls.emplace_back(a);  // render
         };
 
     // columnas de puerta
@@ -494,61 +737,355 @@ void buildEndRoom() {
 // -----------------------------------------------------------------------------
 // Dibujar prisma (rombo) azul oscuro en el pasillo
 // -----------------------------------------------------------------------------
-void greedyMerge();
-void buildFoyerAndCorridor();
-void buildEndRoom();
+void mergeWallRects(LevelGeometry& geo);
+void buildFoyerAndCorridor(LevelGeometry& geo);
+void buildEndRoom(LevelGeometry& geo);
+void buildCollisionGrid(const std::vector<AABB>& walls, CollisionGrid& grid);
+void bakeLevelMesh(LevelGeometry& geo);
+void buildPvs(LevelGeometry& geo);
+void uploadLevelMesh(LevelGeometry& geo);
+static void resetStreaming();
+
+// Nivel integrado equivalente al fichero .lvl (fallback si falta el fichero)
+static LevelData BuiltinLevelData(LevelDifficulty level)
+{
+    const int (*src)[MAP_W] = mazeHard;
+    LevelData d;
+
+    if (level == LevelDifficulty::EASY) {
+        src = mazeEasy;
+        d.prisms = greenPrismsEasy;
+        d.wallTexture = "textures/wall.jpg";
+        d.skyTexture = "textures/panorama.jpg";
+    }
+    else if (level == LevelDifficulty::MEDIUM) {
+        src = mazeMedium;
+        d.prisms = greenPrismsMedium;
+        d.wallTexture = "textures/wall2.jpg";
+        d.skyTexture = "textures/panorama3.jpg";
+    }
+    else { // HARD
+        d.prisms = greenPrismsHard;
+        d.wallTexture = "textures/wall5.jpg";
+        d.skyTexture = "textures/panorama2.jpg";
+    }
 
-static void LoadLevelData()
+    d.width = MAP_W;
+    d.height = MAP_H;
+    d.grid.Resize(MAP_W, MAP_H);
+    for (int z = 0; z < MAP_H; ++z)
+        for (int x = 0; x < MAP_W; ++x)
+            d.grid.Set(x, z, src[z][x] == 1);
+    return d;
+}
+
+static const char* LevelFilePath(LevelDifficulty level)
 {
-    // 1) Elegir matriz y rombos según dificultad
-    const int (*srcMaze)[MAP_W] = nullptr;
+    if (level == LevelDifficulty::EASY)   return "levels/easy.lvl";
+    if (level == LevelDifficulty::MEDIUM) return "levels/medium.lvl";
+    return "levels/hard.lvl";
+}
 
-    if (g_CurrentLevel == LevelDifficulty::EASY) {
-        srcMaze = mazeEasy;
-        greenPrisms = greenPrismsEasy;
-        g_PrismIsRed = true;   // modo "amable"
+// Nivel preparado fuera del hilo de GL, pendiente de subir y activar
+struct PendingLevel {
+    LevelDifficulty level = LevelDifficulty::EASY;
+    LevelGeometry geo;
+    std::vector<CellCoord> prisms;
+    float spawnX = 0.0f;
+    float spawnZ = 0.0f;
+
+    // Texturas: si ya estaban en la caché se reutilizan sin decodificar
+    std::string wallPath;
+    std::string skyPath;
+    TextureImage wallImage;
+    SkyFaces skyFaces;
+    GLuint texWall = 0;
+    GLuint texSky[SKY_FACES] = {};
+
+    int uploadStep = 0;   // siguiente paso de UploadPendingLevelStep
+};
+
+// Carga en segundo plano lanzada al entrar en FADING_OUT
+static std::unique_ptr<PendingLevel> g_PendingLevel;
+static std::future<void> g_PendingLevelJob;
+
+// Textura del muro: de la caché en disco o decodificada (y guardada allí)
+static bool LoadWallImage(const std::string& path, TextureImage& out)
+{
+    if (TextureDiskCache_Load(path, path.c_str(), out))
+        return true;
+    if (!Texture_Decode(path.c_str(), out))
+        return false;
+    TextureDiskCache_Store(path, path.c_str(), out);
+    return true;
+}
+
+// Las caras horneadas dependen también de la orientación del panorama
+static std::string SkyFaceDiskKey(const std::string& path, int face)
+{
+    return path + SkyBox_FaceSuffix(face) + "@" + std::to_string(skyOrient.yawDeg)
+        + "," + std::to_string(skyOrient.pitchDeg) + "," + std::to_string(skyOrient.rollDeg)
+        + (skyOrient.flipV ? ",flipV" : "");
+}
+
+// Cubo del cielo: las seis caras de la caché en disco u horneado de nuevo
+static bool LoadSkyFaces(const std::string& path, SkyFaces& out)
+{
+    bool cached = true;
+    for (int f = 0; f < SKY_FACES && cached; ++f)
+        cached = TextureDiskCache_Load(SkyFaceDiskKey(path, f), path.c_str(), out.faces[f]);
+    if (cached)
+        return true;
+
+    if (!SkyBox_BakeFromEquirect(path.c_str(), skyOrient, out))
+        return false;
+    for (int f = 0; f < SKY_FACES; ++f)
+        TextureDiskCache_Store(SkyFaceDiskKey(path, f), path.c_str(), out.faces[f]);
+    return true;
+}
+
+// 1) Trabajo de CPU: leer el nivel, decodificar texturas con sus mipmaps y
+// construir muros, colisiones y malla. No toca OpenGL ni el nivel activo,
+// así que puede ejecutarse en un hilo aparte.
+static void BuildPendingLevel(PendingLevel& p)
+{
+    PROFILE_SCOPE("BuildPendingLevel");
+    // Fichero proyectado en memoria o laberinto integrado
+    LevelData level;
+    const char* levelPath = LevelFilePath(p.level);
+    if (!LevelFile_Load(levelPath, level)) {
+        std::cerr << "No se pudo cargar " << levelPath
+                  << ", usando laberinto integrado" << std::endl;
+        level = BuiltinLevelData(p.level);
     }
-    else if (g_CurrentLevel == LevelDifficulty::MEDIUM) {
-        srcMaze = mazeMedium;
-        greenPrisms = greenPrismsMedium;
-        g_PrismIsRed = true;   // mismas mecánicas que easy (sin SRX / sin insultos)
+
+    p.geo.mapW = level.width;
+    p.geo.mapH = level.height;
+    p.geo.maze = std::move(level.grid);
+    p.geo.streamed = (size_t)level.width * level.height >= STREAM_MIN_CELLS;
+    p.prisms = std::move(level.prisms);
+
+    // Spawn: el del fichero o, por defecto, dentro del foyer
+    if (level.hasSpawn) {
+        p.spawnX = level.spawnX * CELL;
+        p.spawnZ = level.spawnZ * CELL;
     }
-    else { // HARD
-        srcMaze = mazeHard;
-        greenPrisms = greenPrismsHard;
-        g_PrismIsRed = false;  // modo cruel
+    else {
+        p.spawnX = START_CX(p.geo.mapW);
+        p.spawnZ = START_CZ() + 0.25f * START_D;
     }
 
-    // Copiar la matriz elegida al buffer 'maze' usado por todo el código
-    std::memcpy(maze, srcMaze, sizeof(maze));
+    p.wallPath = level.wallTexture;
+    p.skyPath = level.skyTexture;
 
-    // Reset de rombos activos
-    greenPrismActive.assign(greenPrisms.size(), true);
+    p.texWall = TextureCache_Acquire(p.wallPath);
 
-    // 2) Cargar texturas segun nivel
-    if (g_CurrentLevel == LevelDifficulty::EASY) {
-        texWall = loadTextureSTB("textures/wall.jpg");
-        texSkyEquirect = loadTextureEquirect("textures/panorama.jpg");
+    // El cubo se hornea entero si falta alguna cara en la caché
+    bool skyCached = true;
+    for (int f = 0; f < SKY_FACES; ++f) {
+        p.texSky[f] = TextureCache_Acquire(p.skyPath + SkyBox_FaceSuffix(f));
+        skyCached = skyCached && p.texSky[f];
     }
-    else if (g_CurrentLevel == LevelDifficulty::MEDIUM) {
-        texWall = loadTextureSTB("textures/wall2.jpg");
-        texSkyEquirect = loadTextureEquirect("textures/panorama3.jpg");
+
+    // Muro y cielo a la vez; cada uno reparte además sus filas entre los
+    // hilos que queden libres. Con la caché en disco al día solo se proyecta.
+    bool wallOk = true, skyOk = true;
+    ParallelFor(2, [&](int i) {
+        if (i == 0 && !p.texWall)
+            wallOk = LoadWallImage(p.wallPath, p.wallImage);
+        else if (i == 1 && !skyCached)
+            skyOk = LoadSkyFaces(p.skyPath, p.skyFaces);
+    });
+    if (!wallOk)
+        std::cerr << "Error cargando textura: " << p.wallPath << std::endl;
+    if (!skyOk)
+        std::cerr << "Error cargando panorama: " << p.skyPath << std::endl;
+
+    mergeWallRects(p.geo);
+    buildFoyerAndCorridor(p.geo);
+    buildEndRoom(p.geo);
+    buildCollisionGrid(p.geo.walls, p.geo.coll);
+    bakeLevelMesh(p.geo);
+    if (!p.geo.streamed)
+        buildPvs(p.geo);
+}
+
+// 2) Subidas a GL, una por llamada para repartirlas entre varios frames.
+// Devuelve true cuando ya está todo subido.
+static bool UploadPendingLevelStep(PendingLevel& p)
+{
+    PROFILE_SCOPE("UploadPendingLevelStep");
+    switch (p.uploadStep) {
+    case 0:
+        if (!p.texWall)
+            p.texWall = TextureCache_Insert(p.wallPath, p.wallImage, GL_REPEAT, GL_REPEAT);
+        p.wallImage = TextureImage();
+        break;
+    case 1: case 2: case 3: case 4: case 5: case 6: {
+        // Una cara del cielo por paso; CLAMP_TO_EDGE evita costuras
+        const int f = p.uploadStep - 1;
+        if (!p.texSky[f])
+            p.texSky[f] = TextureCache_Insert(p.skyPath + SkyBox_FaceSuffix(f),
+                p.skyFaces.faces[f], GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
+        p.skyFaces.faces[f] = TextureImage();
+        break;
     }
-    else { // HARD
-        texWall = loadTextureSTB("textures/wall5.jpg");
-        texSkyEquirect = loadTextureEquirect("textures/panorama2.jpg");
+    case 7:
+        uploadLevelMesh(p.geo);
+        break;
+    default:
+        return true;
     }
+    return ++p.uploadStep >= 8;
+}
+
+// 3) Activar el nivel ya subido: solo intercambio de datos
+static void CommitPendingLevel(PendingLevel& p)
+{
+    PROFILE_SCOPE("CommitPendingLevel");
+    g_CurrentLevel = p.level;
+
+    // EASY y MEDIUM: modo "amable" (sin SRX / sin insultos); HARD: modo cruel
+    g_PrismIsRed = (g_CurrentLevel != LevelDifficulty::HARD);
+
+    std::swap(g_Level, p.geo);
+    if (p.geo.wallList)
+        glDeleteLists(p.geo.wallList, p.geo.listCount);   // malla del nivel anterior
+    resetStreaming();
 
-    // 3) Reconstruir geometría de muros y habitaciones
-    greedyMerge();
-    buildFoyerAndCorridor();
-    buildEndRoom();
+    greenPrisms = std::move(p.prisms);
+    greenPrismActive.assign(greenPrisms.size(), true);
+    g_PrismBatchDirty = true;
+
+    PLAYER_SPAWN_X = p.spawnX;
+    PLAYER_SPAWN_Z = p.spawnZ;
+
+    // Las texturas del nivel anterior quedan en la caché sin referencias
+    TextureCache_Release(texWall);
+    texWall = p.texWall;
+    gHasSkyTexture = true;
+    for (int f = 0; f < SKY_FACES; ++f) {
+        TextureCache_Release(texSky[f]);
+        texSky[f] = p.texSky[f];
+        gHasSkyTexture = gHasSkyTexture && texSky[f];
+    }
 
-    // 4) Inicializar puzzles para este nivel
+    // Inicializar puzzles para este nivel (barato, y el estado de puzzles
+    // lo lee ImGui en el hilo principal)
     Puzzles_Init((int)greenPrisms.size());
 }
 
-void drawGreenDiamond() {
+// Carga síncrona de g_CurrentLevel (arranque y F1/F2/F3)
+static void LoadLevelData()
+{
+    PROFILE_SCOPE("LoadLevelData");
+    PendingLevel p;
+    p.level = g_CurrentLevel;
+    BuildPendingLevel(p);
+    while (!UploadPendingLevelStep(p)) {}
+    CommitPendingLevel(p);
+}
+
+// Lanza en segundo plano la preparación de 'level'
+static void StartAsyncLevelLoad(LevelDifficulty level)
+{
+    g_PendingLevel = std::make_unique<PendingLevel>();
+    g_PendingLevel->level = level;
+
+    PendingLevel* p = g_PendingLevel.get();
+    g_PendingLevelJob = std::async(std::launch::async, [p] {
+        Profiler_SetThreadName("Carga de nivel");
+        BuildPendingLevel(*p);
+    });
+}
+
+// Llamado cada frame durante el fade: cuando el hilo termina, sube un paso
+// por frame. Devuelve true cuando el nivel pendiente se puede activar.
+static bool PumpAsyncLevelLoad()
+{
+    if (!g_PendingLevel)
+        return false;
+
+    if (g_PendingLevelJob.valid()) {
+        if (g_PendingLevelJob.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return false;
+        g_PendingLevelJob.get();
+        return false;   // la primera subida, en el siguiente frame
+    }
+    return UploadPendingLevelStep(*g_PendingLevel);
+}
+
+// -----------------------------------------------------------------------------
+// Prismas (rombos): un octaedro compartido y un único lote por nivel
+// -----------------------------------------------------------------------------
+// GL 1.1 no tiene instancing: cada prisma activo copia el octaedro ya
+// trasladado a un array común, que se dibuja con un glDrawArrays y un solo
+// cambio de material. El array se rehace solo al cambiar la lista de prismas
+// o la máscara greenPrismActive.
+
+struct PrismVertex { float nx, ny, nz, x, y, z; };
+
+static const int   PRISM_VERTS = 24;
+static const float PRISM_Y = 1.0f;
+
+static PrismVertex g_PrismMesh[PRISM_VERTS];
+static std::vector<PrismVertex> g_PrismBatch;
+
+static void buildPrismMesh() {
+    const float h = 1.0f;
+    const float r = 0.5f;
+
+    const float top[3] = { 0.0f,  h,  0.0f };
+    const float bottom[3] = { 0.0f, -h,  0.0f };
+    const float e[4][3] = {
+        {  r,   0.0f,  0.0f },
+        { 0.0f, 0.0f,  r },
+        { -r,   0.0f,  0.0f },
+        { 0.0f, 0.0f, -r }
+    };
+
+    // caras superiores con normal hacia arriba, inferiores hacia abajo
+    int n = 0;
+    auto put = [&n](const float* p, float ny) {
+        g_PrismMesh[n++] = { 0.0f, ny, 0.0f, p[0], p[1], p[2] };
+    };
+    for (int i = 0; i < 4; ++i) {
+        put(top, 1.0f); put(e[i], 1.0f); put(e[(i + 1) % 4], 1.0f);
+    }
+    for (int i = 0; i < 4; ++i) {
+        put(bottom, -1.0f); put(e[(i + 1) % 4], -1.0f); put(e[i], -1.0f);
+    }
+}
+
+static void rebuildPrismBatch() {
+    g_PrismBatch.clear();
+    g_PrismBatch.reserve(greenPrisms.size() * PRISM_VERTS);
+
+    for (int i = 0; i < (int)greenPrisms.size(); ++i) {
+        if (i < (int)greenPrismActive.size() && !greenPrismActive[i])
+            continue;
+
+        const auto& c = greenPrisms[i];
+        float worldX = (c.x + 0.5f) * CELL;
+        float worldZ = (c.z + 0.5f) * CELL;
+
+        for (const PrismVertex& v : g_PrismMesh) {
+            PrismVertex w = v;
+            w.x += worldX;
+            w.y += PRISM_Y;
+            w.z += worldZ;
+            g_PrismBatch.push_back(w);
+        }
+    }
+    g_PrismBatchDirty = false;
+}
+
+void drawGreenDiamondsInCorridor() {
+    if (g_PrismBatchDirty)
+        rebuildPrismBatch();
+    if (g_PrismBatch.empty())
+        return;
+
     glPushAttrib(GL_ENABLE_BIT | GL_CURRENT_BIT | GL_LIGHTING_BIT | GL_TEXTURE_BIT);
 
     glDisable(GL_TEXTURE_2D);
@@ -575,60 +1112,19 @@ void drawGreenDiamond() {
     glMaterialfv(GL_FRONT, GL_SPECULAR, specular);
     glMaterialf(GL_FRONT, GL_SHININESS, 0.0f);
 
-    const float h = 1.0f;
-    const float r = 0.5f;
-
-    const GLfloat top[3] = { 0.0f,  h,  0.0f };
-    const GLfloat bottom[3] = { 0.0f, -h,  0.0f };
-    const GLfloat e1[3] = { r,   0.0f,  0.0f };
-    const GLfloat e2[3] = { 0.0f, 0.0f,  r };
-    const GLfloat e3[3] = { -r,   0.0f,  0.0f };
-    const GLfloat e4[3] = { 0.0f, 0.0f, -r };
-
-    glBegin(GL_TRIANGLES);
-
-    glNormal3f(0.0f, 1.0f, 0.0f);
-    // caras superiores
-    glVertex3fv(top); glVertex3fv(e1); glVertex3fv(e2);
-    glVertex3fv(top); glVertex3fv(e2); glVertex3fv(e3);
-    glVertex3fv(top); glVertex3fv(e3); glVertex3fv(e4);
-    glVertex3fv(top); glVertex3fv(e4); glVertex3fv(e1);
-
-    glNormal3f(0.0f, -1.0f, 0.0f);
-    // caras inferiores
-    glVertex3fv(bottom); glVertex3fv(e2); glVertex3fv(e1);
-    glVertex3fv(bottom); glVertex3fv(e3); glVertex3fv(e2);
-    glVertex3fv(bottom); glVertex3fv(e4); glVertex3fv(e3);
-    glVertex3fv(bottom); glVertex3fv(e1); glVertex3fv(e4);
-
-    glEnd();
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glNormalPointer(GL_FLOAT, sizeof(PrismVertex), &g_PrismBatch[0].nx);
+    glVertexPointer(3, GL_FLOAT, sizeof(PrismVertex), &g_PrismBatch[0].x);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)g_PrismBatch.size());
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    Profiler_CountDraw((int)g_PrismBatch.size());
 
     glPopAttrib();
 }
 
 
-void drawGreenDiamondsInCorridor() {
-    glPushMatrix();
-
-    for (int i = 0; i < (int)greenPrisms.size(); ++i) {
-        if (i < (int)greenPrismActive.size() && !greenPrismActive[i])
-            continue;
-
-        const auto& c = greenPrisms[i];
-
-        float worldX = (c.x + 0.5f) * CELL;
-        float worldZ = (c.z + 0.5f) * CELL;
-
-        glPushMatrix();
-        glTranslatef(worldX, 1.0f, worldZ);
-        drawGreenDiamond();
-        glPopMatrix();
-    }
-
-    glPopMatrix();
-}
-
-
 // -----------------------------------------------------------------------------
 // Suelos oscuros
 // -----------------------------------------------------------------------------
@@ -664,12 +1160,13 @@ static inline void drawDarkFloorArea(float x0, float z0, float x1, float z1) {
     glVertex3f(x1, y, z1);
     glVertex3f(x0, y, z1);
     glEnd();
+    Profiler_CountDraw(4);
 }
 
 
 void drawEndRoomFloor() {
     const float centerX = ENTRANCE_CX();
-    const float labEndZ = MAP_H * CELL;
+    const float labEndZ = g_Level.mapH * CELL;
     const float roomW = 4.0f * CELL;
     const float roomD = 3.0f * CELL;
     const float halfW = 0.5f * roomW;
@@ -686,14 +1183,108 @@ void drawEndRoomFloor() {
 // Portal
 // -----------------------------------------------------------------------------
 
+// La geometría es fija: solo cambian radios, colores y alfa con el tiempo.
+// Las ondas son de la forma sin(k * ang + w * t); con las tablas de
+// sin/cos(k * ang) basta con sin(k*ang + p) = sin(k*ang)cos(p) + cos(k*ang)sin(p),
+// así que cada frame cuesta 5 llamadas trigonométricas en lugar de ~600.
+static const int   PORTAL_SEG = 72;
+static const float PORTAL_INNER_R = 0.90f;
+static const float PORTAL_OUTER_R = 1.20f;
+static const int   PORTAL_HALO_VERTS = 16 * 2 * (32 + 1);   // gluSphere 32x16 (tiras de quads)
+
+struct PortalVertex {
+    float r, g, b, a;
+    float x, y, z;
+};
+
+struct PortalMesh {
+    // tablas por segmento: [k][i] = sin/cos(k * ang_i), k = 1..4
+    float sinK[5][PORTAL_SEG + 1];
+    float cosK[5][PORTAL_SEG + 1];
+
+    PortalVertex fan[PORTAL_SEG + 2];          // centro + borde interior
+    PortalVertex ring[2 * (PORTAL_SEG + 1)];   // exterior/interior alternos
+    GLuint haloList = 0;                       // esfera del halo
+    bool built = false;
+};
+
+static PortalMesh g_Portal;
+
+static void buildPortalMesh() {
+    PortalMesh& m = g_Portal;
+    for (int i = 0; i <= PORTAL_SEG; ++i) {
+        float ang = (2.0f * (float)M_PI * i) / PORTAL_SEG;
+        for (int k = 1; k <= 4; ++k) {
+            m.sinK[k][i] = sinf(k * ang);
+            m.cosK[k][i] = cosf(k * ang);
+        }
+    }
+
+    m.fan[0] = { 0.15f, 0.8f, 1.0f, 0.95f, 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i <= PORTAL_SEG; ++i) {
+        m.fan[i + 1] = { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        m.ring[2 * i] = { 0.1f, 0.9f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f };
+        m.ring[2 * i + 1] = { 0.0f, 0.6f, 1.0f, 0.35f,
+            PORTAL_INNER_R * m.cosK[1][i], PORTAL_INNER_R * m.sinK[1][i], 0.0f };
+    }
+
+    GLUquadric* q = gluNewQuadric();
+    m.haloList = glGenLists(1);
+    glNewList(m.haloList, GL_COMPILE);
+    gluSphere(q, PORTAL_OUTER_R * 1.05f, 32, 16);
+    glEndList();
+    gluDeleteQuadric(q);
+
+    m.built = true;
+}
+
+// sin(k * ang_i + p) a partir de las tablas
+static inline float portalWave(int k, int i, float sinP, float cosP) {
+    return g_Portal.sinK[k][i] * cosP + g_Portal.cosK[k][i] * sinP;
+}
+
+static void animatePortalMesh(float t) {
+    PortalMesh& m = g_Portal;
+    const float s25 = sinf(2.5f * t), c25 = cosf(2.5f * t);
+    const float s1 = sinf(t), c1 = cosf(t);
+    const float s15 = sinf(1.5f * t), c15 = cosf(1.5f * t);
+    const float s4 = sinf(4.0f * t), c4 = cosf(4.0f * t);
+
+    for (int i = 0; i <= PORTAL_SEG; ++i) {
+        const float cosA = m.cosK[1][i], sinA = m.sinK[1][i];
+
+        PortalVertex& f = m.fan[i + 1];
+        float r = PORTAL_INNER_R + 0.08f * portalWave(3, i, s25, c25);
+        f.g = 0.6f + 0.3f * portalWave(2, i, s1, c1);
+        f.a = 0.65f + 0.25f * portalWave(4, i, s15, c15);
+        f.x = r * cosA;
+        f.y = r * sinA;
+
+        float pulse = 0.5f + 0.5f * portalWave(3, i, s4, c4);
+        float r1 = PORTAL_OUTER_R + 0.05f * pulse;
+        m.ring[2 * i].x = r1 * cosA;
+        m.ring[2 * i].y = r1 * sinA;
+    }
+}
+
+static void drawPortalArrays(const PortalVertex* v, int count, GLenum mode) {
+    glColorPointer(4, GL_FLOAT, sizeof(PortalVertex), &v->r);
+    glVertexPointer(3, GL_FLOAT, sizeof(PortalVertex), &v->x);
+    glDrawArrays(mode, 0, count);
+    Profiler_CountDraw(count);
+}
+
 void drawPortal(float x, float y, float z) {
+    if (!g_Portal.built)
+        buildPortalMesh();
+
     glPushAttrib(GL_ENABLE_BIT | GL_CURRENT_BIT | GL_DEPTH_BUFFER_BIT | GL_LIGHTING_BIT);
     glPushMatrix();
 
     glTranslatef(x, y, z);
 
-    float dx = camX - x;
-    float dz = camZ - z;
+    float dx = renderCamX - x;
+    float dz = renderCamZ - z;
 
     float yawToCam = atan2f(dx, dz) * 180.0f / M_PI;
     glRotatef(yawToCam, 0.0f, 1.0f, 0.0f);
@@ -706,50 +1297,18 @@ void drawPortal(float x, float y, float z) {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE);
     glDepthMask(GL_FALSE);
 
-    const int   SEG = 72;
-    const float innerR = 0.90f;
-    const float outerR = 1.20f;
-
-    glBegin(GL_TRIANGLE_FAN);
-    glColor4f(0.15f, 0.8f, 1.0f, 0.95f);
-    glVertex3f(0.0f, 0.0f, 0.0f);
-
-    for (int i = 0; i <= SEG; ++i) {
-        float ang = (2.0f * (float)M_PI * i) / SEG;
-
-        float r = innerR + 0.08f * sinf(3.0f * ang + 2.5f * t);
-
-        float g = 0.6f + 0.3f * sinf(ang * 2.0f + t);
-        float b = 1.0f;
-        float a = 0.65f + 0.25f * sinf(ang * 4.0f + 1.5f * t);
+    animatePortalMesh(t);
 
-        glColor4f(0.0f, g, b, a);
-        glVertex3f(r * cosf(ang), r * sinf(ang), 0.0f);
-    }
-    glEnd();
-
-    glBegin(GL_TRIANGLE_STRIP);
-    for (int i = 0; i <= SEG; ++i) {
-        float ang = (2.0f * (float)M_PI * i) / SEG;
-
-        float pulse = 0.5f + 0.5f * sinf(4.0f * t + 3.0f * ang);
-
-        float r0 = innerR;
-        float r1 = outerR + 0.05f * pulse;
-
-        glColor4f(0.1f, 0.9f, 1.0f, 1.0f);
-        glVertex3f(r1 * cosf(ang), r1 * sinf(ang), 0.0f);
-
-        glColor4f(0.0f, 0.6f, 1.0f, 0.35f);
-        glVertex3f(r0 * cosf(ang), r0 * sinf(ang), 0.0f);
-    }
-    glEnd();
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    drawPortalArrays(g_Portal.fan, PORTAL_SEG + 2, GL_TRIANGLE_FAN);
+    drawPortalArrays(g_Portal.ring, 2 * (PORTAL_SEG + 1), GL_TRIANGLE_STRIP);
+    glPopClientAttrib();
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
     glColor4f(0.1f, 0.55f, 1.0f, 0.18f);
-    GLUquadric* q = gluNewQuadric();
-    gluSphere(q, outerR * 1.05f, 32, 16);
-    gluDeleteQuadric(q);
+    glCallList(g_Portal.haloList);
+    Profiler_CountDraw(PORTAL_HALO_VERTS);
 
     glDepthMask(GL_TRUE);
     glPopMatrix();
@@ -757,175 +1316,809 @@ void drawPortal(float x, float y, float z) {
 }
 
 // -----------------------------------------------------------------------------
-// Greedy merge de paredes
+// Fusión de paredes en rectángulos
 // -----------------------------------------------------------------------------
 
-void greedyMerge() {
-    wallRects.clear();
+// Greedy por defecto; Minimum da menos cajas (y menos AABB de colisión) a
+// cambio de unos ms más al cargar. Se lee en el hilo de carga.
+static RectCoverMode g_RectCoverMode = RectCoverMode::Greedy;
 
-    bool used[MAP_H][MAP_W];
-    std::memset(used, 0, sizeof(used));
+static constexpr AABB wallBoxFromRect(const Rect& r)
+{
+    return { r.x * CELL, 0.0f, r.z * CELL, (r.x + r.w) * CELL, wallH, (r.z + r.l) * CELL };
+}
 
-    for (int z = 0; z < MAP_H; ++z) {
-        for (int x = 0; x < MAP_W; ++x) {
-            if (maze[z][x] != 1 || used[z][x]) continue;
-            int w = 1;
-            while (x + w < MAP_W && maze[z][x + w] == 1 && !used[z][x + w]) ++w;
+// Laberintos integrados: cajas y AABB horneados en compilación con el mismo
+// greedy que en ejecución (RectCover_GreedyScan)
+using BuiltinMaze = int[MAP_H][MAP_W];
+using BuiltinRows = std::array<uint64_t, MAP_H>;   // una palabra por fila
 
-            int  l = 1;
-            bool expand = true;
-            while (z + l < MAP_H && expand) {
-                for (int i = 0; i < w; ++i) {
-                    if (maze[z + l][x + i] != 1 || used[z + l][x + i]) {
-                        expand = false;
-                        break;
-                    }
-                }
-                if (expand) ++l;
-            }
-            for (int dz = 0; dz < l; ++dz)
-                for (int dx = 0; dx < w; ++dx)
-                    used[z + dz][x + dx] = true;
+static_assert(MAP_W <= 64, "los laberintos integrados caben en una palabra por fila");
 
-            wallRects.push_back({ x, z, w, l });
-        }
-    }
+static constexpr BuiltinRows packBuiltinMaze(const BuiltinMaze& maze)
+{
+    BuiltinRows rows{};
+    for (int z = 0; z < MAP_H; ++z)
+        for (int x = 0; x < MAP_W; ++x)
+            rows[z] |= (uint64_t)(maze[z][x] == 1) << x;
+    return rows;
+}
 
-    walls.clear();
-    for (const auto& r : wallRects) {
-        float x0 = r.x * CELL;
-        float z0 = r.z * CELL;
-        float x1 = (r.x + r.w) * CELL;
-        float z1 = (r.z + r.l) * CELL;
-        walls.push_back({ x0, 0.0f, z0, x1, wallH, z1 });
-    }
+template <typename Emit>
+static constexpr void scanBuiltinMaze(const BuiltinMaze& maze, Emit& emit)
+{
+    BuiltinRows rows = packBuiltinMaze(maze);
+    RectCover_GreedyScan(MAP_W, MAP_H, rows.data(), 1, emit);
 }
 
-// -----------------------------------------------------------------------------
-// Muros biselados
-// -----------------------------------------------------------------------------
+static constexpr int builtinRectCount(const BuiltinMaze& maze)
+{
+    int n = 0;
+    auto emit = [&](const Rect&) { ++n; };
+    scanBuiltinMaze(maze, emit);
+    return n;
+}
 
-void drawBeveledBox(float sx, float h, float sz, float bevel) {
-    float bMax = 0.2f * std::fmin(sx, sz);
-    float b = clampf(bevel, 0.0f, bMax);
-    float x0 = 0, x1 = sx, z0 = 0, z1 = sz, y0 = 0, y1 = h;
-    float xl = b, xr = sx - b, zf = b, zb = sz - b;
+template <int N>
+static constexpr std::array<Rect, N> bakeBuiltinRects(const BuiltinMaze& maze)
+{
+    std::array<Rect, N> rects{};
+    int n = 0;
+    auto emit = [&](const Rect& r) { rects[n++] = r; };
+    scanBuiltinMaze(maze, emit);
+    return rects;
+}
 
-    glColor4f(1, 1, 1, 1);
+template <size_t N>
+static constexpr std::array<AABB, N> bakeBuiltinWalls(const std::array<Rect, N>& rects)
+{
+    std::array<AABB, N> walls{};
+    for (size_t i = 0; i < N; ++i)
+        walls[i] = wallBoxFromRect(rects[i]);
+    return walls;
+}
 
-    glBegin(GL_QUADS);
-    // derecha
-    {
-        float u0 = 0, u1 = (zb - zf) * UV_SCALE, v0 = 0, v1 = (y1 - y0) * UV_SCALE;
-        glNormal3f(1, 0, 0);
-        glTexCoord2f(u0, v0); glVertex3f(xr, y0, zf);
-        glTexCoord2f(u0, v1); glVertex3f(xr, y1, zf);
-        glTexCoord2f(u1, v1); glVertex3f(xr, y1, zb);
-        glTexCoord2f(u1, v0); glVertex3f(xr, y0, zb);
+// Cada celda muro en exactamente una caja y ninguna celda libre cubierta
+template <size_t N>
+static constexpr bool coversMazeExactly(const BuiltinMaze& maze, const std::array<Rect, N>& rects)
+{
+    int hits[MAP_H][MAP_W] = {};
+    for (const Rect& r : rects) {
+        if (r.w < 1 || r.l < 1 || r.x < 0 || r.z < 0 || r.x + r.w > MAP_W || r.z + r.l > MAP_H)
+            return false;
+        for (int z = r.z; z < r.z + r.l; ++z)
+            for (int x = r.x; x < r.x + r.w; ++x)
+                ++hits[z][x];
     }
-    // izquierda
-    {
-        float u0 = 0, u1 = (zb - zf) * UV_SCALE, v0 = 0, v1 = (y1 - y0) * UV_SCALE;
-        glNormal3f(-1, 0, 0);
-        glTexCoord2f(u0, v0); glVertex3f(xl, y0, zb);
-        glTexCoord2f(u0, v1); glVertex3f(xl, y1, zb);
-        glTexCoord2f(u1, v1); glVertex3f(xl, y1, zf);
-        glTexCoord2f(u1, v0); glVertex3f(xl, y0, zf);
+    for (int z = 0; z < MAP_H; ++z)
+        for (int x = 0; x < MAP_W; ++x)
+            if (hits[z][x] != maze[z][x])
+                return false;
+    return true;
+}
+
+static constexpr auto bakedRectsEasy = bakeBuiltinRects<builtinRectCount(mazeEasy)>(mazeEasy);
+static constexpr auto bakedRectsMedium = bakeBuiltinRects<builtinRectCount(mazeMedium)>(mazeMedium);
+static constexpr auto bakedRectsHard = bakeBuiltinRects<builtinRectCount(mazeHard)>(mazeHard);
+static constexpr auto bakedWallsEasy = bakeBuiltinWalls(bakedRectsEasy);
+static constexpr auto bakedWallsMedium = bakeBuiltinWalls(bakedRectsMedium);
+static constexpr auto bakedWallsHard = bakeBuiltinWalls(bakedRectsHard);
+
+static_assert(coversMazeExactly(mazeEasy, bakedRectsEasy), "cajas horneadas de mazeEasy");
+static_assert(coversMazeExactly(mazeMedium, bakedRectsMedium), "cajas horneadas de mazeMedium");
+static_assert(coversMazeExactly(mazeHard, bakedRectsHard), "cajas horneadas de mazeHard");
+
+static constexpr BuiltinRows packedMazeEasy = packBuiltinMaze(mazeEasy);
+static constexpr BuiltinRows packedMazeMedium = packBuiltinMaze(mazeMedium);
+static constexpr BuiltinRows packedMazeHard = packBuiltinMaze(mazeHard);
+
+// Si el laberinto es uno de los integrados (también cuando el .lvl trae la
+// misma rejilla) copia lo horneado en vez de fusionar
+static bool copyBakedBuiltin(LevelGeometry& geo)
+{
+    struct Baked {
+        const BuiltinRows& rows;
+        const Rect* rects;
+        const AABB* walls;
+        size_t count;
+    };
+    static const Baked baked[] = {
+        { packedMazeEasy, bakedRectsEasy.data(), bakedWallsEasy.data(), bakedRectsEasy.size() },
+        { packedMazeMedium, bakedRectsMedium.data(), bakedWallsMedium.data(), bakedRectsMedium.size() },
+        { packedMazeHard, bakedRectsHard.data(), bakedWallsHard.data(), bakedRectsHard.size() },
+    };
+
+    if (geo.maze.Width() != MAP_W || geo.maze.Height() != MAP_H)
+        return false;
+    for (const Baked& b : baked) {
+        if (!std::equal(b.rows.begin(), b.rows.end(), geo.maze.Words().begin()))
+            continue;
+        geo.wallRects.assign(b.rects, b.rects + b.count);
+        geo.walls.assign(b.walls, b.walls + b.count);
+        return true;
     }
-    // fondo
-    {
-        float u0 = 0, u1 = (xr - xl) * UV_SCALE, v0 = 0, v1 = (y1 - y0) * UV_SCALE;
-        glNormal3f(0, 0, 1);
-        glTexCoord2f(u0, v0); glVertex3f(xl, y0, zb);
-        glTexCoord2f(u0, v1); glVertex3f(xl, y1, zb);
-        glTexCoord2f(u1, v1); glVertex3f(xr, y1, zb);
-        glTexCoord2f(u1, v0); glVertex3f(xr, y0, zb);
+    return false;
+}
+
+void mergeWallRects(LevelGeometry& geo) {
+    PROFILE_SCOPE("mergeWallRects");
+    geo.wallRects.clear();
+    geo.walls.clear();
+    if (geo.streamed)
+        return;   // cada trozo hace sus cajas (ver bakeStreamChunk)
+    if (g_RectCoverMode == RectCoverMode::Greedy && copyBakedBuiltin(geo))
+        return;
+
+    RectCover_Build(geo.maze, g_RectCoverMode, geo.wallRects);
+
+    for (const auto& r : geo.wallRects)
+        geo.walls.push_back(wallBoxFromRect(r));
+}
+
+// -----------------------------------------------------------------------------
+// Muros biselados (malla estática horneada al cargar el nivel)
+// -----------------------------------------------------------------------------
+
+// Lado de una caja para visibleSpans(): +x, -x, +z, -z
+enum class BoxSide { PosX, NegX, PosZ, NegZ };
+
+// Tramos [lo, hi] del lado que no quedan pegados a otra celda muro. Sin
+// rectángulo (foyer, sala final, decorado) el lado entero es visible.
+//
+// Los lados van metidos 'bevel' dentro de la caja, igual que los de la caja
+// vecina: un tramo que linda con ella (celda tapada en medio del lado, o
+// esquina interior tras el extremo) se alarga 'bevel' hasta el plano de su
+// cara. Cortado en la frontera de celda quedaría una rendija de 2 * bevel
+// entre las dos cajas, abierta de lado a lado.
+static void visibleSpans(const BitGrid& maze, const Rect* rect, BoxSide side,
+    float lo, float hi, float bevel, std::vector<std::pair<float, float>>& spans)
+{
+    spans.clear();
+    if (!rect) {
+        spans.push_back({ lo, hi });
+        return;
     }
-    // frente
-    {
-        float u0 = 0, u1 = (xr - xl) * UV_SCALE, v0 = 0, v1 = (y1 - y0) * UV_SCALE;
-        glNormal3f(0, 0, -1);
-        glTexCoord2f(u0, v0); glVertex3f(xr, y0, zf);
-        glTexCoord2f(u0, v1); glVertex3f(xr, y1, zf);
-        glTexCoord2f(u1, v1); glVertex3f(xl, y1, zf);
-        glTexCoord2f(u1, v0); glVertex3f(xl, y0, zf);
-    }
-    // techo
-    {
-        float u0 = 0, u1 = (xr - xl) * UV_SCALE, v0 = 0, v1 = (zb - zf) * UV_SCALE;
-        glNormal3f(0, 1, 0);
-        glTexCoord2f(u0, v0); glVertex3f(xl, y1, zf);
-        glTexCoord2f(u0, v1); glVertex3f(xl, y1, zb);
-        glTexCoord2f(u1, v1); glVertex3f(xr, y1, zb);
-        glTexCoord2f(u1, v0); glVertex3f(xr, y1, zf);
-    }
-    // base
-    {
-        glNormal3f(0, -1, 0);
-        glTexCoord2f(0, 0); glVertex3f(x0, y0, z0);
-        glTexCoord2f(0, 1); glVertex3f(x0, y0, z1);
-        glTexCoord2f(1, 1); glVertex3f(x1, y0, z1);
-        glTexCoord2f(1, 0); glVertex3f(x1, y0, z0);
+
+    const bool alongZ = (side == BoxSide::PosX || side == BoxSide::NegX);
+    const int first = alongZ ? rect->z : rect->x;
+    const int last = first + (alongZ ? rect->l : rect->w);
+    const int inside = side == BoxSide::PosX ? rect->x + rect->w - 1
+                     : side == BoxSide::NegX ? rect->x
+                     : side == BoxSide::PosZ ? rect->z + rect->l - 1
+                     : rect->z;
+    const int outside = (side == BoxSide::PosX || side == BoxSide::PosZ) ? inside + 1 : inside - 1;
+
+    // Celda i de la fila/columna 'line' paralela al lado
+    auto wall = [&](int line, int i) {
+        return alongZ ? maze.Test(line, i) : maze.Test(i, line);
+    };
+    // Tras el extremo e el muro sigue en línea con el rectángulo y dobla
+    // hacia fuera: la cara de esa caja cruza el plano de este lado
+    auto innerCorner = [&](int e) { return wall(inside, e) && wall(outside, e); };
+
+    for (int i = first; i < last; ) {
+        if (wall(outside, i)) { ++i; continue; }
+        int j = i;
+        while (j < last && !wall(outside, j)) ++j;
+        float a = (i > first || innerCorner(first - 1)) ? i * CELL - bevel : lo;
+        float c = (j < last || innerCorner(last)) ? j * CELL + bevel : hi;
+        spans.push_back({ a, c });
+        i = j;
     }
-    glEnd();
+}
+
+// Emite la caja biselada de tamaño sx*h*sz con origen en (ox, 0, oz).
+// Mismos vértices, normales y UVs que el antiguo dibujo en modo inmediato,
+// salvo las caras que nunca se ven: la base (contra el suelo), el techo (la
+// cámara no pasa de ~3 m y los muros miden wallH) y, si la caja es un
+// rectángulo del laberinto, los tramos de lado pegados a otra celda muro y
+// los biseles de esquinas encerradas por muros a ambos lados. Las caras van
+// a 'verts' y el contorno superior a 'edges'.
+static void bakeBeveledBox(const BitGrid& maze, std::vector<LevelVertex>& verts, std::vector<float>& edges,
+    float ox, float oz, float sx, float h, float sz, float bevel, const Rect* rect = nullptr) {
+    float bMax = 0.2f * std::fmin(sx, sz);
+    float b = clampf(bevel, 0.0f, bMax);
+    float x0 = ox, x1 = ox + sx, z0 = oz, z1 = oz + sz, y0 = 0, y1 = h;
+    float xl = x0 + b, xr = x1 - b, zf = z0 + b, zb = z1 - b;
+
+    float nx = 0, ny = 0, nz = 0;
+    auto N = [&](float x, float y, float z) { nx = x; ny = y; nz = z; };
+    auto V = [&](float u, float v, float x, float y, float z) {
+        verts.push_back({ u, v, nx, ny, nz, x, y, z });
+    };
+
+    // Quad vertical de (ax, az) a (bx, bz); u sigue midiéndose desde el
+    // extremo del lado completo para que la textura no salte entre tramos
+    const float v1 = (y1 - y0) * UV_SCALE;
+    auto side = [&](float ax, float az, float ua, float bx, float bz, float ub) {
+        V(ua, 0, ax, y0, az);
+        V(ua, v1, ax, y1, az);
+        V(ub, v1, bx, y1, bz);
+        V(ub, 0, bx, y0, bz);
+    };
+
+    static thread_local std::vector<std::pair<float, float>> spans;
+
+    // derecha
+    N(1, 0, 0);
+    visibleSpans(maze, rect, BoxSide::PosX, zf, zb, b, spans);
+    for (const auto& s : spans)
+        side(xr, s.first, (s.first - zf) * UV_SCALE, xr, s.second, (s.second - zf) * UV_SCALE);
+    // izquierda
+    N(-1, 0, 0);
+    visibleSpans(maze, rect, BoxSide::NegX, zf, zb, b, spans);
+    for (const auto& s : spans)
+        side(xl, s.second, (zb - s.second) * UV_SCALE, xl, s.first, (zb - s.first) * UV_SCALE);
+    // fondo
+    N(0, 0, 1);
+    visibleSpans(maze, rect, BoxSide::PosZ, xl, xr, b, spans);
+    for (const auto& s : spans)
+        side(s.first, zb, (s.first - xl) * UV_SCALE, s.second, zb, (s.second - xl) * UV_SCALE);
+    // frente
+    N(0, 0, -1);
+    visibleSpans(maze, rect, BoxSide::NegZ, xl, xr, b, spans);
+    for (const auto& s : spans)
+        side(s.second, zf, (xr - s.second) * UV_SCALE, s.first, zf, (xr - s.first) * UV_SCALE);
 
     const float diag = b * 1.41421356f;
     const float uDiag = diag * UV_SCALE;
     const float vY = (h)*UV_SCALE;
 
-    glBegin(GL_QUADS);
+    // Esquina (sx, sz) = (+1|-1, +1|-1) encerrada: dos de sus tres celdas
+    // vecinas son muro. O tapan los dos lados, o uno de ellos sigue de largo
+    // por la esquina interior (ver visibleSpans) y el bisel sobresaldría.
+    auto cornerHidden = [&](int cx, int cz) {
+        if (!rect)
+            return false;
+        int lastX = cx > 0 ? rect->x + rect->w - 1 : rect->x;
+        int lastZ = cz > 0 ? rect->z + rect->l - 1 : rect->z;
+        const int walls = (int)maze.Test(lastX + cx, lastZ) + (int)maze.Test(lastX, lastZ + cz)
+                        + (int)maze.Test(lastX + cx, lastZ + cz);
+        return walls >= 2;
+    };
+
     // biseles
-    glNormal3f(0.707f, 0, 0.707f);
-    glTexCoord2f(0, 0);   glVertex3f(xr, 0, zb);
-    glTexCoord2f(0, vY);  glVertex3f(xr, h, zb);
-    glTexCoord2f(uDiag, vY); glVertex3f(x1, h, z1);
-    glTexCoord2f(uDiag, 0);  glVertex3f(x1, 0, z1);
-
-    glNormal3f(0.707f, 0, -0.707f);
-    glTexCoord2f(0, 0);   glVertex3f(xr, 0, zf);
-    glTexCoord2f(0, vY);  glVertex3f(xr, h, zf);
-    glTexCoord2f(uDiag, vY); glVertex3f(x1, h, 0);
-    glTexCoord2f(uDiag, 0);  glVertex3f(x1, 0, 0);
-
-    glNormal3f(-0.707f, 0, 0.707f);
-    glTexCoord2f(0, 0);   glVertex3f(xl, 0, zb);
-    glTexCoord2f(0, vY);  glVertex3f(xl, h, zb);
-    glTexCoord2f(uDiag, vY); glVertex3f(0, h, z1);
-    glTexCoord2f(uDiag, 0);  glVertex3f(0, 0, z1);
-
-    glNormal3f(-0.707f, 0, -0.707f);
-    glTexCoord2f(0, 0);   glVertex3f(xl, 0, zf);
-    glTexCoord2f(0, vY);  glVertex3f(xl, h, zf);
-    glTexCoord2f(uDiag, vY); glVertex3f(0, h, 0);
-    glTexCoord2f(uDiag, 0);  glVertex3f(0, 0, 0);
-    glEnd();
+    if (!cornerHidden(1, 1)) {
+        N(0.707f, 0, 0.707f);
+        V(0, 0, xr, 0, zb);
+        V(0, vY, xr, h, zb);
+        V(uDiag, vY, x1, h, z1);
+        V(uDiag, 0, x1, 0, z1);
+    }
 
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_LIGHTING);
-    glColor3f(0.18f, 0.18f, 0.22f);
-    glBegin(GL_LINE_LOOP);
-    glVertex3f(xl, h, zf); glVertex3f(xl, h, zb);
-    glVertex3f(xr, h, zb); glVertex3f(xr, h, zf);
-    glEnd();
-    glEnable(GL_LIGHTING);
-    glEnable(GL_TEXTURE_2D);
+    if (!cornerHidden(1, -1)) {
+        N(0.707f, 0, -0.707f);
+        V(0, 0, xr, 0, zf);
+        V(0, vY, xr, h, zf);
+        V(uDiag, vY, x1, h, z0);
+        V(uDiag, 0, x1, 0, z0);
+    }
+
+    if (!cornerHidden(-1, 1)) {
+        N(-0.707f, 0, 0.707f);
+        V(0, 0, xl, 0, zb);
+        V(0, vY, xl, h, zb);
+        V(uDiag, vY, x0, h, z1);
+        V(uDiag, 0, x0, 0, z1);
+    }
+
+    if (!cornerHidden(-1, -1)) {
+        N(-0.707f, 0, -0.707f);
+        V(0, 0, xl, 0, zf);
+        V(0, vY, xl, h, zf);
+        V(uDiag, vY, x0, h, z0);
+        V(uDiag, 0, x0, 0, z0);
+    }
+
+    // contorno superior (antes un GL_LINE_LOOP por caja)
+    const float loop[4][2] = { { xl, zf }, { xl, zb }, { xr, zb }, { xr, zf } };
+    for (int i = 0; i < 4; ++i) {
+        const float* a = loop[i];
+        const float* c = loop[(i + 1) % 4];
+        edges.insert(edges.end(), { a[0], h, a[1], c[0], h, c[1] });
+    }
 }
 
-void drawAABB_AsBeveled(const AABB& b, float bevel) {
-    glPushMatrix();
-    glTranslatef(b.minx, 0.0f, b.minz);
-    drawBeveledBox(b.maxx - b.minx, wallH, b.maxz - b.minz, bevel);
-    glPopMatrix();
+// -----------------------------------------------------------------------------
+// Frustum de la cámara (descarte de trozos de muro)
+// -----------------------------------------------------------------------------
+
+// Planos n·p + d >= 0 hacia dentro: izq., der., abajo, arriba, cerca, lejos
+struct Frustum {
+    float n[6][3];
+    float d[6];
+};
+
+static Frustum g_ViewFrustum;
+
+// Mismos parámetros que la perspectiva de World_OnResize() y la cámara de
+// setCamera(): el frustum es exactamente el volumen que se rasteriza
+static void buildViewFrustum(Frustum& fr, const float eye[3], const float f[3],
+    float fovYDeg, float aspect, float zNear, float zFar)
+{
+    // Base de la cámara con up = +Y (pitch nunca llega a ±90°)
+    float len = sqrtf(f[0] * f[0] + f[2] * f[2]);
+    const float r[3] = { -f[2] / len, 0.0f, f[0] / len };
+    const float u[3] = {
+        r[1] * f[2] - r[2] * f[1],
+        r[2] * f[0] - r[0] * f[2],
+        r[0] * f[1] - r[1] * f[0]
+    };
+
+    const float tanY = tanf(0.5f * fovYDeg * (float)M_PI / 180.0f);
+    const float tanX = tanY * aspect;
+
+    for (int k = 0; k < 3; ++k) {
+        fr.n[0][k] = f[k] * tanX + r[k];
+        fr.n[1][k] = f[k] * tanX - r[k];
+        fr.n[2][k] = f[k] * tanY + u[k];
+        fr.n[3][k] = f[k] * tanY - u[k];
+        fr.n[4][k] = f[k];
+        fr.n[5][k] = -f[k];
+    }
+    for (int i = 0; i < 6; ++i)
+        fr.d[i] = -(fr.n[i][0] * eye[0] + fr.n[i][1] * eye[1] + fr.n[i][2] * eye[2]);
+    fr.d[4] -= zNear;
+    fr.d[5] += zFar;
+}
+
+// Conservador: false solo si la caja queda entera detrás de algún plano
+static bool frustumTouchesAABB(const Frustum& fr, const AABB& b)
+{
+    for (int i = 0; i < 6; ++i) {
+        const float* n = fr.n[i];
+        float px = n[0] >= 0.0f ? b.maxx : b.minx;
+        float py = n[1] >= 0.0f ? b.maxy : b.miny;
+        float pz = n[2] >= 0.0f ? b.maxz : b.minz;
+        if (n[0] * px + n[1] * py + n[2] * pz + fr.d[i] < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+// Hornea todos los muros del nivel (laberinto, foyer, sala final, decorado)
+// en un único buffer intercalado, agrupado por trozos de CHUNK_CELLS celdas.
+// Solo CPU: la subida va en uploadLevelMesh().
+// Debe llamarse tras mergeWallRects(), buildFoyerAndCorridor() y buildEndRoom().
+void bakeLevelMesh(LevelGeometry& geo) {
+    PROFILE_SCOPE("bakeLevelMesh");
+    geo.wallVerts.clear();
+    geo.edgeVerts.clear();
+    geo.chunks.clear();
+    geo.cellChunk.assign(geo.streamed ? 0 : (size_t)geo.mapW * geo.mapH, -1);   // solo para el PVS
+    geo.exteriorChunks.clear();
+
+    struct BakeBox { float ox, oz, sx, sz; };
+    std::vector<BakeBox> boxes;
+    boxes.reserve(geo.wallRects.size() + geo.extraWalls.size() + decorWalls.size());
+    for (const auto& r : geo.wallRects)
+        boxes.push_back({ r.x * CELL, r.z * CELL, r.w * CELL, r.l * CELL });
+    for (const auto* list : { &geo.extraWalls, &decorWalls })
+        for (const auto& w : *list)
+            boxes.push_back({ w.minx, w.minz, w.maxx - w.minx, w.maxz - w.minz });
+    if (boxes.empty())
+        return;
+
+    // Rejilla de trozos sobre la extensión de todas las cajas (el foyer
+    // queda en z negativas, fuera del laberinto)
+    float minX = boxes[0].ox, minZ = boxes[0].oz, maxX = minX, maxZ = minZ;
+    for (const auto& b : boxes) {
+        minX = std::min(minX, b.ox);
+        minZ = std::min(minZ, b.oz);
+        maxX = std::max(maxX, b.ox + b.sx);
+        maxZ = std::max(maxZ, b.oz + b.sz);
+    }
+    const int gridW = (int)((maxX - minX) / CHUNK_SIZE) + 1;
+    const int gridH = (int)((maxZ - minZ) / CHUNK_SIZE) + 1;
+
+    std::vector<std::vector<int>> buckets((size_t)gridW * gridH);
+    for (int i = 0; i < (int)boxes.size(); ++i) {
+        const auto& b = boxes[i];
+        int cx = std::clamp((int)((b.ox + 0.5f * b.sx - minX) / CHUNK_SIZE), 0, gridW - 1);
+        int cz = std::clamp((int)((b.oz + 0.5f * b.sz - minZ) / CHUNK_SIZE), 0, gridH - 1);
+        buckets[(size_t)cz * gridW + cx].push_back(i);
+    }
+
+    for (const auto& bucket : buckets) {
+        if (bucket.empty())
+            continue;
+
+        const int chunkIndex = (int)geo.chunks.size();
+
+        LevelChunk c;
+        c.firstVert = (int)geo.wallVerts.size();
+        c.firstEdge = (int)geo.edgeVerts.size() / 3;
+        c.bounds = { FLT_MAX, 0.0f, FLT_MAX, -FLT_MAX, wallH, -FLT_MAX };
+        for (int i : bucket) {
+            // Las primeras cajas son los rectángulos del laberinto
+            if (i < (int)geo.wallRects.size()) {
+                const Rect& r = geo.wallRects[i];
+                for (int z = r.z; z < r.z + r.l; ++z)
+                    for (int x = r.x; x < r.x + r.w; ++x)
+                        geo.cellChunk[(size_t)z * geo.mapW + x] = chunkIndex;
+            }
+            else {
+                c.exterior = true;
+            }
+
+            const auto& b = boxes[i];
+            const Rect* rect = i < (int)geo.wallRects.size() ? &geo.wallRects[i] : nullptr;
+            bakeBeveledBox(geo.maze, geo.wallVerts, geo.edgeVerts, b.ox, b.oz, b.sx, wallH, b.sz, 0.12f, rect);
+            c.bounds.minx = std::min(c.bounds.minx, b.ox);
+            c.bounds.minz = std::min(c.bounds.minz, b.oz);
+            c.bounds.maxx = std::max(c.bounds.maxx, b.ox + b.sx);
+            c.bounds.maxz = std::max(c.bounds.maxz, b.oz + b.sz);
+        }
+        c.vertCount = (int)geo.wallVerts.size() - c.firstVert;
+        c.edgeCount = (int)geo.edgeVerts.size() / 3 - c.firstEdge;
+        geo.chunks.push_back(c);
+        if (c.exterior)
+            geo.exteriorChunks.push_back(chunkIndex);
+    }
 }
 
 // -----------------------------------------------------------------------------
-// Sky equirect
+// PVS: trozos de muro visibles desde cada celda libre del laberinto
 // -----------------------------------------------------------------------------
+// Los muros llegan a wallH y la cámara nunca pasa de ahí, así que basta con
+// visibilidad 2D sobre la rejilla. Un muro entra en el conjunto de una celda
+// si algún segmento desde cualquier punto de la celda llega a él sin
+// atravesar otro muro: campo de visión permisivo preciso (Duerig), exacto y
+// por tanto conservador para cualquier posición de la cámara dentro de la
+// celda. Toda la geometría de una caja queda dentro de sus celdas, así que
+// basta con marcar el trozo de cada celda muro visible. Los trozos
+// exteriores (foyer, sala final) se dibujan siempre; el borde del laberinto
+// es convexo y una visual que sale de él no vuelve a entrar.
+
+// Recta de (xi, yi) a (xf, yf) en coordenadas de cuadrante: esquinas de
+// celda enteras, la celda origen es [0,1]x[0,1]
+struct PvsLine {
+    int xi, yi, xf, yf;
+
+    int relativeSlope(int x, int y) const {
+        return (yf - yi) * (xf - x) - (xf - xi) * (yf - y);
+    }
+    bool below(int x, int y) const { return relativeSlope(x, y) > 0; }
+    bool belowOrCollinear(int x, int y) const { return relativeSlope(x, y) >= 0; }
+    bool above(int x, int y) const { return relativeSlope(x, y) < 0; }
+    bool aboveOrCollinear(int x, int y) const { return relativeSlope(x, y) <= 0; }
+    bool collinear(int x, int y) const { return relativeSlope(x, y) == 0; }
+    bool collinear(const PvsLine& o) const { return collinear(o.xi, o.yi) && collinear(o.xf, o.yf); }
+};
+
+// Esquina de un muro que ha recortado una vista; 'parent' es la anterior
+struct PvsBump {
+    int x, y;
+    int parent;
+};
+
+// Haz de rectas entre 'shallow' y 'steep' que sale de la celda origen
+struct PvsView {
+    PvsLine shallow, steep;
+    int shallowBump = -1;
+    int steepBump = -1;
+};
+
+// Memoria de trabajo de un hilo
+struct PvsScratch {
+    std::vector<PvsView> views;
+    std::vector<PvsBump> bumps;
+};
+
+static void addShallowBump(PvsScratch& s, size_t v, int x, int y)
+{
+    PvsView& view = s.views[v];
+    view.shallow.xf = x;
+    view.shallow.yf = y;
+    s.bumps.push_back({ x, y, view.shallowBump });
+    view.shallowBump = (int)s.bumps.size() - 1;
+    for (int b = view.steepBump; b >= 0; b = s.bumps[b].parent) {
+        if (view.shallow.above(s.bumps[b].x, s.bumps[b].y)) {
+            view.shallow.xi = s.bumps[b].x;
+            view.shallow.yi = s.bumps[b].y;
+        }
+    }
+}
+
+static void addSteepBump(PvsScratch& s, size_t v, int x, int y)
+{
+    PvsView& view = s.views[v];
+    view.steep.xf = x;
+    view.steep.yf = y;
+    s.bumps.push_back({ x, y, view.steepBump });
+    view.steepBump = (int)s.bumps.size() - 1;
+    for (int b = view.shallowBump; b >= 0; b = s.bumps[b].parent) {
+        if (view.steep.below(s.bumps[b].x, s.bumps[b].y)) {
+            view.steep.xi = s.bumps[b].x;
+            view.steep.yi = s.bumps[b].y;
+        }
+    }
+}
+
+// Quita la vista si ha quedado reducida a una recta por una esquina del
+// origen; devuelve si sigue viva
+static bool checkView(PvsScratch& s, size_t v)
+{
+    const PvsView& view = s.views[v];
+    if (view.shallow.collinear(view.steep) && (view.shallow.collinear(0, 1) || view.shallow.collinear(1, 0))) {
+        s.views.erase(s.views.begin() + v);
+        return false;
+    }
+    return true;
+}
+
+// Celda (x, y) del cuadrante: si cae en una vista y es muro, marca su trozo
+// y recorta la vista. 'v' avanza por las vistas a lo largo de la diagonal.
+static void visitPvsCell(const LevelGeometry& geo, int cx, int cz, int x, int y,
+    size_t& v, PvsScratch& s, std::vector<int>& hits)
+{
+    const int tlx = x, tly = y + 1;       // esquina superior izquierda
+    const int brx = x + 1, bry = y;       // esquina inferior derecha
+    while (v < s.views.size() && s.views[v].steep.belowOrCollinear(brx, bry))
+        ++v;
+    if (v == s.views.size() || s.views[v].shallow.aboveOrCollinear(tlx, tly))
+        return;
+
+    // Fuera del laberinto solo hay trozos exteriores
+    if (cx < 0 || cz < 0 || cx >= geo.mapW || cz >= geo.mapH || !geo.maze.Get(cx, cz))
+        return;
+    const int chunk = geo.cellChunk[(size_t)cz * geo.mapW + cx];
+    if (chunk >= 0)
+        hits.push_back(chunk);
+
+    const bool pastShallow = s.views[v].shallow.above(brx, bry);
+    const bool pastSteep = s.views[v].steep.below(tlx, tly);
+    if (pastShallow && pastSteep) {
+        s.views.erase(s.views.begin() + v);   // tapa la vista entera
+    }
+    else if (pastShallow) {
+        addShallowBump(s, v, tlx, tly);
+        checkView(s, v);
+    }
+    else if (pastSteep) {
+        addSteepBump(s, v, brx, bry);
+        checkView(s, v);
+    }
+    else {
+        // En medio: la vista se parte en dos, una a cada lado del muro
+        const PvsView copy = s.views[v];
+        s.views.insert(s.views.begin() + v, copy);
+        size_t steepView = v + 1;
+        addSteepBump(s, v, brx, bry);
+        if (!checkView(s, v))
+            --steepView;
+        addShallowBump(s, steepView, tlx, tly);
+        checkView(s, steepView);
+        v = steepView;
+    }
+}
+
+// Un cuadrante (dx, dz) desde la celda (sx, sz), hasta extentX x extentZ
+// celdas. Las celdas se recorren por diagonales alejándose del origen.
+static void castPvsQuadrant(const LevelGeometry& geo, int sx, int sz, int dx, int dz,
+    int extentX, int extentZ, PvsScratch& s, std::vector<int>& hits)
+{
+    extentX = std::max(extentX, 1);
+    extentZ = std::max(extentZ, 1);
+    s.views.clear();
+    s.bumps.clear();
+    PvsView first;
+    first.shallow = { 0, 1, extentX, 0 };
+    first.steep = { 1, 0, 0, extentZ };
+    s.views.push_back(first);
+
+    for (int i = 1; i <= extentX + extentZ && !s.views.empty(); ++i) {
+        size_t v = 0;
+        const int maxJ = std::min(i, extentZ);
+        for (int j = std::max(0, i - extentX); j <= maxJ && v < s.views.size(); ++j) {
+            const int x = i - j, y = j;
+            visitPvsCell(geo, sx + x * dx, sz + y * dz, x, y, v, s, hits);
+        }
+    }
+}
+
+// Trozos con algún muro visible desde la celda libre (x, z)
+static void castPvsCell(const LevelGeometry& geo, int x, int z, PvsScratch& s, std::vector<int>& hits)
+{
+    const int left = x, right = geo.mapW - 1 - x;
+    const int down = z, up = geo.mapH - 1 - z;
+    castPvsQuadrant(geo, x, z, 1, 1, right, up, s, hits);
+    castPvsQuadrant(geo, x, z, 1, -1, right, down, s, hits);
+    castPvsQuadrant(geo, x, z, -1, -1, left, down, s, hits);
+    castPvsQuadrant(geo, x, z, -1, 1, left, up, s, hits);
+}
+
+// Rellena pvsCellSet / pvsSetStart / pvsWords. Solo CPU, tras bakeLevelMesh().
+void buildPvs(LevelGeometry& geo) {
+    PROFILE_SCOPE("buildPvs");
+    const int mapW = geo.mapW, mapH = geo.mapH;
+    geo.pvsCellSet.assign((size_t)mapW * mapH, PVS_NONE);
+    geo.pvsSetStart.clear();
+    geo.pvsWords.clear();
+
+    // Cada bloque de filas produce sus propios conjuntos; luego se concatenan
+    struct Block {
+        std::vector<uint32_t> setStart;
+        std::vector<PvsWord> words;
+    };
+    const int numBlocks = std::min(mapH, 4 * (int)std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<Block> blocks(numBlocks);
+
+    ParallelFor(numBlocks, [&](int b) {
+        Block& out = blocks[b];
+        const int z0 = (int)((long long)mapH * b / numBlocks);
+        const int z1 = (int)((long long)mapH * (b + 1) / numBlocks);
+
+        PvsScratch scratch;
+        std::vector<int> hits;
+        std::vector<PvsWord> words;
+        for (int z = z0; z < z1; ++z) {
+            const uint64_t* row = geo.maze.Row(z);
+            for (int x = BitRow_NextClear(row, 0, mapW); x < mapW; x = BitRow_NextClear(row, x + 1, mapW)) {
+                const size_t cell = (size_t)z * mapW + x;
+
+                hits.clear();
+                castPvsCell(geo, x, z, scratch, hits);
+                std::sort(hits.begin(), hits.end());
+                hits.erase(std::unique(hits.begin(), hits.end()), hits.end());
+
+                words.clear();
+                for (int c : hits) {
+                    if (geo.chunks[c].exterior)
+                        continue;   // van siempre, ver collectPvsChunks()
+                    uint32_t w = (uint32_t)c >> 6;
+                    if (words.empty() || words.back().index != w)
+                        words.push_back({ w, 0 });
+                    words.back().bits |= 1ull << (c & 63);
+                }
+
+                // Igual que el de la celda anterior (mismo pasillo): compartir
+                const size_t n = out.setStart.size();
+                const size_t last = n ? out.setStart[n - 1] : 0;
+                bool same = n && out.words.size() - last == words.size() &&
+                    std::equal(words.begin(), words.end(), out.words.begin() + last,
+                        [](const PvsWord& a, const PvsWord& c) { return a.index == c.index && a.bits == c.bits; });
+                if (!same) {
+                    out.setStart.push_back((uint32_t)out.words.size());
+                    out.words.insert(out.words.end(), words.begin(), words.end());
+                }
+                // índice local; se corrige al concatenar
+                geo.pvsCellSet[cell] = (uint32_t)out.setStart.size() - 1;
+            }
+        }
+    });
+
+    std::vector<uint32_t> setBase(numBlocks);
+    for (int b = 0; b < numBlocks; ++b) {
+        setBase[b] = (uint32_t)geo.pvsSetStart.size();
+        const uint32_t wordBase = (uint32_t)geo.pvsWords.size();
+        for (uint32_t s : blocks[b].setStart)
+            geo.pvsSetStart.push_back(wordBase + s);
+        geo.pvsWords.insert(geo.pvsWords.end(), blocks[b].words.begin(), blocks[b].words.end());
+    }
+    geo.pvsSetStart.push_back((uint32_t)geo.pvsWords.size());
+
+    ParallelFor(numBlocks, [&](int b) {
+        const int z0 = (int)((long long)mapH * b / numBlocks);
+        const int z1 = (int)((long long)mapH * (b + 1) / numBlocks);
+        for (size_t cell = (size_t)z0 * mapW; cell < (size_t)z1 * mapW; ++cell)
+            if (geo.pvsCellSet[cell] != PVS_NONE)
+                geo.pvsCellSet[cell] += setBase[b];
+    });
+}
+
+// Compila dos display lists por trozo a partir de 'base': muros y contorno
+static void compileChunkLists(GLuint base, const std::vector<LevelChunk>& chunks,
+    const std::vector<LevelVertex>& verts, const std::vector<float>& edges) {
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+    for (int i = 0; i < (int)chunks.size(); ++i) {
+        const LevelChunk& c = chunks[i];
+
+        glNewList(base + 2 * i, GL_COMPILE);
+        if (c.vertCount > 0) {
+            glInterleavedArrays(GL_T2F_N3F_V3F, 0, verts.data() + c.firstVert);
+            glDrawArrays(GL_QUADS, 0, c.vertCount);
+        }
+        glEndList();
+
+        glNewList(base + 2 * i + 1, GL_COMPILE);
+        if (c.edgeCount > 0) {
+            glInterleavedArrays(GL_V3F, 0, edges.data() + 3 * c.firstEdge);
+            glDrawArrays(GL_LINES, 0, c.edgeCount);
+        }
+        glEndList();
+    }
+
+    glPopClientAttrib();
+}
+
+// Sube la malla horneada una sola vez como display lists, dos por trozo
+// (hilo de GL)
+void uploadLevelMesh(LevelGeometry& geo) {
+    if (geo.wallList == 0 && !geo.chunks.empty()) {
+        geo.listCount = 2 * (GLsizei)geo.chunks.size();
+        geo.wallList = glGenLists(geo.listCount);
+    }
+    compileChunkLists(geo.wallList, geo.chunks, geo.wallVerts, geo.edgeVerts);
+}
+
+// Trozos candidatos: los del PVS de la celda de la cámara más los
+// exteriores; fuera del laberinto (foyer, sala final), todos
+static void collectPvsChunks(float x, float z, std::vector<int>& out) {
+    const LevelGeometry& geo = g_Level;
+    const int cx = (int)floorf(x / CELL);
+    const int cz = (int)floorf(z / CELL);
+
+    uint32_t set = PVS_NONE;
+    if (cx >= 0 && cz >= 0 && cx < geo.mapW && cz < geo.mapH && !geo.pvsCellSet.empty())
+        set = geo.pvsCellSet[(size_t)cz * geo.mapW + cx];
+
+    if (set == PVS_NONE) {
+        for (int i = 0; i < (int)geo.chunks.size(); ++i)
+            out.push_back(i);
+        return;
+    }
+
+    for (uint32_t w = geo.pvsSetStart[set]; w < geo.pvsSetStart[set + 1]; ++w) {
+        uint64_t bits = geo.pvsWords[w].bits;
+        for (int b = 0; bits; ++b, bits >>= 1)
+            if (bits & 1)
+                out.push_back((int)(geo.pvsWords[w].index * 64 + b));
+    }
+    out.insert(out.end(), geo.exteriorChunks.begin(), geo.exteriorChunks.end());
+}
+
+// Dibuja los trozos de la malla horneada visibles desde la celda de la cámara
+// y dentro de su frustum, con el material/textura ya configurados por drawMaze().
+// En un laberinto en streaming se suman las partes de los trozos residentes.
+static void drawLevelMesh() {
+    struct VisibleChunk {
+        GLuint list;   // muros; el contorno en list + 1
+        const LevelChunk* chunk;
+    };
+    static std::vector<int> candidates;
+    static std::vector<VisibleChunk> visible;
+    candidates.clear();
+    visible.clear();
+
+    collectPvsChunks(renderCamX, renderCamZ, candidates);
+    for (int i : candidates)
+        if (frustumTouchesAABB(g_ViewFrustum, g_Level.chunks[i].bounds))
+            visible.push_back({ g_Level.wallList + 2 * i, &g_Level.chunks[i] });
+
+    for (int i : g_Stream.live) {
+        const StreamChunk& sc = g_Stream.chunks[i];
+        if (sc.state != StreamState::Resident || !frustumTouchesAABB(g_ViewFrustum, sc.bounds))
+            continue;
+        for (int j = 0; j < (int)sc.parts.size(); ++j)
+            if (frustumTouchesAABB(g_ViewFrustum, sc.parts[j].bounds))
+                visible.push_back({ sc.lists + 2 * j, &sc.parts[j] });
+    }
+
+    glColor4f(1, 1, 1, 1);
+    for (const VisibleChunk& v : visible) {
+        glCallList(v.list);
+        Profiler_CountDraw(v.chunk->vertCount);
+    }
+
+    glDisable(GL_TEXTURE_2D);
+    glDisable(GL_LIGHTING);
+    glColor3f(0.18f, 0.18f, 0.22f);
+    for (const VisibleChunk& v : visible) {
+        glCallList(v.list + 1);
+        Profiler_CountDraw(v.chunk->edgeCount);
+    }
+    glEnable(GL_LIGHTING);
+    glEnable(GL_TEXTURE_2D);
+}
 
 // -----------------------------------------------------------------------------
-// Sky equirect con degradacion del mundo
+// Sky (cubo pre-horneado) con degradacion del mundo
 // -----------------------------------------------------------------------------
-void drawSkyEquirect(float radius) {
+// Las caras se hornean al cargar el nivel (SkyBox_BakeFromEquirect) con la
+// orientación del panorama ya aplicada: aquí solo quedan 6 quads.
+void drawSkyBox(float halfSize) {
     glDepthMask(GL_FALSE);
     glDisable(GL_LIGHTING);
     glDisable(GL_CULL_FACE);
@@ -936,20 +2129,8 @@ void drawSkyEquirect(float radius) {
     else
         glDisable(GL_TEXTURE_2D);
 
-    glMatrixMode(GL_TEXTURE);
-    glPushMatrix();
-    if (skyFlipV) {
-        glScalef(1.0f, -1.0f, 1.0f);
-        glTranslatef(0.0f, -1.0f, 0.0f);
-    }
-    glMatrixMode(GL_MODELVIEW);
-
     glPushMatrix();
-    glTranslatef(camX, camY, camZ);
-
-    glRotatef(skyYawDeg, 0, 1, 0);
-    glRotatef(skyPitchDeg, 1, 0, 0);
-    glRotatef(skyRollDeg, 0, 0, 1);
+    glTranslatef(renderCamX, renderCamY, renderCamZ);
 
     // Color del cielo segun nivel
     if (g_WorldStage == 0 || g_WorldStage == 1) {
@@ -965,20 +2146,22 @@ void drawSkyEquirect(float radius) {
         glColor4f(0.02f, 0.04f, 0.12f, 1.0f);
     }
 
-    if (useTexture)
-        glBindTexture(GL_TEXTURE_2D, texSkyEquirect);
-    else
-        glBindTexture(GL_TEXTURE_2D, 0);
-
-    const int slices = 64, stacks = 48;
-    gluSphere(gQuadricSky, radius, slices, stacks);
+    static const float corners[4][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+    for (int f = 0; f < SKY_FACES; ++f) {
+        glBindTexture(GL_TEXTURE_2D, useTexture ? texSky[f] : 0);
+        glBegin(GL_QUADS);
+        for (const auto& c : corners) {
+            float d[3];
+            SkyBox_FaceDirection(f, c[0], c[1], d);
+            glTexCoord2f(c[0], c[1]);
+            glVertex3f(d[0] * halfSize, d[1] * halfSize, d[2] * halfSize);
+        }
+        glEnd();
+        Profiler_CountDraw(4);
+    }
 
     glPopMatrix();
 
-    glMatrixMode(GL_TEXTURE);
-    glPopMatrix();
-    glMatrixMode(GL_MODELVIEW);
-
     glDepthMask(GL_TRUE);
     glEnable(GL_CULL_FACE);
     glEnable(GL_LIGHTING);
@@ -990,9 +2173,38 @@ void drawSkyEquirect(float radius) {
 // Suelos foyer/pasillo
 // -----------------------------------------------------------------------------
 
-void buildFoyerAndCorridor() {
+void buildFoyerAndCorridor(LevelGeometry& geo) {
+    std::vector<AABB>& extraWalls = geo.extraWalls;
     extraWalls.clear();
 
+    const float sx0 = START_CX(geo.mapW) - 0.5f * START_W;
+    const float sx1 = START_CX(geo.mapW) + 0.5f * START_W;
+    const float sz0 = START_CZ() - 0.5f * START_D;
+    const float sz1 = START_CZ() + 0.5f * START_D;
+
+    const float corridorHalf = 0.5f * CORRIDOR_W;
+    const float cx0 = START_CX(geo.mapW) - corridorHalf;
+    const float cx1 = START_CX(geo.mapW) + corridorHalf;
+    const float cz0 = sz1;
+    const float cz1 = 0.0f;
+
+    const float eps = 0.05f;
+
+    // cinco muros del foyer
+    extraWalls.emplace_back(MakeAABB(sx0, 0.0f, sz1 - eps, cx0, wallH, sz1 + eps));
+    extraWalls.emplace_back(MakeAABB(cx1, 0.0f, sz1 - eps, sx1, wallH, sz1 + eps));
+    extraWalls.emplace_back(MakeAABB(sx0 - eps, 0.0f, sz0, sx0 + eps, wallH, sz1));
+    extraWalls.emplace_back(MakeAABB(sx1 - eps, 0.0f, sz0, sx1 + eps, wallH, sz1));
+    extraWalls.emplace_back(MakeAABB(sx0, 0.0f, sz0 - eps, sx1, wallH, sz0 + eps));
+
+    // paredes del pasillo
+    extraWalls.emplace_back(MakeAABB(cx0 - eps, 0.0f, cz0, cx0 + eps, wallH, cz1));
+    extraWalls.emplace_back(MakeAABB(cx1 - eps, 0.0f, cz0, cx1 + eps, wallH, cz1));
+
+    geo.walls.insert(geo.walls.end(), extraWalls.begin(), extraWalls.end());
+}
+
+void drawFoyerCorridorFloors() {
     const float sx0 = START_CX() - 0.5f * START_W;
     const float sx1 = START_CX() + 0.5f * START_W;
     const float sz0 = START_CZ() - 0.5f * START_D;
@@ -1004,62 +2216,492 @@ void buildFoyerAndCorridor() {
     const float cz0 = sz1;
     const float cz1 = 0.0f;
 
-    const float eps = 0.05f;
+    drawDarkFloorArea(sx0, sz0, sx1, sz1); // foyer
+    drawDarkFloorArea(cx0, cz0, cx1, cz1); // pasillo
+}
+
+// -----------------------------------------------------------------------------
+// Colisiones
+// -----------------------------------------------------------------------------
+
+// Broadphase: rejilla uniforme de celdas CELL x CELL que cubre todos los muros
+// (laberinto, foyer con z negativa y sala final). Cada celda guarda los índices
+// de 'walls' que la solapan en formato compacto: los de la celda c están en
+// cellWalls[cellStart[c] .. cellStart[c + 1]).
+static inline int collCellOf(float v) { return (int)std::floor(v / CELL); }
+
+// Debe llamarse cuando 'walls' ya está completo (tras buildEndRoom()). También
+// la usa cada trozo de un laberinto en streaming con sus propias cajas.
+void buildCollisionGrid(const std::vector<AABB>& walls, CollisionGrid& grid) {
+    PROFILE_SCOPE("buildCollisionGrid");
+    grid.cellStart.clear();
+    grid.cellWalls.clear();
+    grid.w = grid.h = 0;
+    if (walls.empty()) return;
+
+    int x0 = collCellOf(walls[0].minx), x1 = collCellOf(walls[0].maxx);
+    int z0 = collCellOf(walls[0].minz), z1 = collCellOf(walls[0].maxz);
+    for (const auto& w : walls) {
+        x0 = std::min(x0, collCellOf(w.minx)); x1 = std::max(x1, collCellOf(w.maxx));
+        z0 = std::min(z0, collCellOf(w.minz)); z1 = std::max(z1, collCellOf(w.maxz));
+    }
+    grid.x0 = x0;
+    grid.z0 = z0;
+    grid.w = x1 - x0 + 1;
+    grid.h = z1 - z0 + 1;
+
+    const int numCells = grid.w * grid.h;
+    std::vector<int>& start = grid.cellStart;
+    std::vector<int>& cellWalls = grid.cellWalls;
+
+    // 1ª pasada: contar muros por celda; 2ª pasada: rellenar índices
+    start.assign(numCells + 1, 0);
+    for (int pass = 0; pass < 2; ++pass) {
+        std::vector<int> cursor;
+        if (pass == 1) {
+            for (int c = 0; c < numCells; ++c)
+                start[c + 1] += start[c];
+            cellWalls.resize(start.back());
+            cursor.assign(start.begin(), start.end() - 1);
+        }
+
+        for (int i = 0; i < (int)walls.size(); ++i) {
+            const AABB& w = walls[i];
+            for (int gz = collCellOf(w.minz) - z0; gz <= collCellOf(w.maxz) - z0; ++gz)
+                for (int gx = collCellOf(w.minx) - x0; gx <= collCellOf(w.maxx) - x0; ++gx) {
+                    int c = gz * grid.w + gx;
+                    if (pass == 0) ++start[c + 1];
+                    else cellWalls[cursor[c]++] = i;
+                }
+        }
+    }
+}
+
+// Recorre los muros de las 3x3 celdas alrededor de (x, z); el radio del
+// jugador es mucho menor que CELL, así que no hace falta mirar más lejos.
+template <typename Test>
+static bool gridHasWall(const std::vector<AABB>& walls, const CollisionGrid& grid,
+    float x, float z, const Test& test) {
+    int cx = collCellOf(x) - grid.x0;
+    int cz = collCellOf(z) - grid.z0;
+    for (int gz = std::max(cz - 1, 0); gz <= std::min(cz + 1, grid.h - 1); ++gz)
+        for (int gx = std::max(cx - 1, 0); gx <= std::min(cx + 1, grid.w - 1); ++gx) {
+            int c = gz * grid.w + gx;
+            for (int k = grid.cellStart[c]; k < grid.cellStart[c + 1]; ++k)
+                if (test(walls[grid.cellWalls[k]])) return true;
+        }
+    return false;
+}
+
+static const int STREAM_CHUNK_CELLS = 32;   // lado de un trozo en streaming
+
+// Muros del nivel activo cerca de (x, z). En un laberinto en streaming se
+// miran también los trozos de esas 3x3 celdas (hasta cuatro): su rejilla si
+// está residente y, si no, las celdas muro del laberinto tal cual, para que
+// el jugador no atraviese muros que aún no se han cargado.
+template <typename Test>
+static bool anyNearbyWall(float x, float z, const Test& test) {
+    const LevelGeometry& geo = g_Level;
+    if (gridHasWall(geo.walls, geo.coll, x, z, test))
+        return true;
+    if (!geo.streamed)
+        return false;
+
+    const int cx = collCellOf(x), cz = collCellOf(z);
+    const int gx0 = std::max(cx - 1, 0), gx1 = std::min(cx + 1, geo.mapW - 1);
+    const int gz0 = std::max(cz - 1, 0), gz1 = std::min(cz + 1, geo.mapH - 1);
+    if (gx0 > gx1 || gz0 > gz1)
+        return false;
+
+    for (int tz = gz0 / STREAM_CHUNK_CELLS; tz <= gz1 / STREAM_CHUNK_CELLS; ++tz)
+        for (int tx = gx0 / STREAM_CHUNK_CELLS; tx <= gx1 / STREAM_CHUNK_CELLS; ++tx) {
+            const StreamChunk& sc = g_Stream.chunks[(size_t)tz * g_Stream.chunksX + tx];
+            if (auto coll = std::atomic_load(&sc.collision)) {
+                if (gridHasWall(coll->walls, coll->grid, x, z, test))
+                    return true;
+                continue;
+            }
+
+            const int x0 = std::max(gx0, tx * STREAM_CHUNK_CELLS);
+            const int x1 = std::min(gx1, tx * STREAM_CHUNK_CELLS + STREAM_CHUNK_CELLS - 1);
+            const int z0 = std::max(gz0, tz * STREAM_CHUNK_CELLS);
+            const int z1 = std::min(gz1, tz * STREAM_CHUNK_CELLS + STREAM_CHUNK_CELLS - 1);
+            for (int gz = z0; gz <= z1; ++gz)
+                for (int gx = x0; gx <= x1; ++gx)
+                    if (geo.maze.Get(gx, gz) && test(wallBoxFromRect(Rect{ gx, gz, 1, 1 })))
+                        return true;
+        }
+    return false;
+}
+
+bool collideXZ(float nx, float nz, float radius) {
+    return anyNearbyWall(nx, nz, [&](const AABB& w) {
+        float cx = clampf(nx, w.minx, w.maxx);
+        float cz = clampf(nz, w.minz, w.maxz);
+        float dx = nx - cx, dz = nz - cz;
+        return dx * dx + dz * dz < radius * radius;
+    });
+}
+
+bool collideY(float x, float y, float z, float radius, float height) {
+    AABB p{ x - radius, y - 0.1f, z - radius,
+            x + radius, y + height, z + radius };
+    return anyNearbyWall(x, z, [&](const AABB& w) {
+        return !(p.maxx <= w.minx || p.minx >= w.maxx ||
+            p.maxy <= w.miny || p.miny >= w.maxy ||
+            p.maxz <= w.minz || p.minz >= w.maxz);
+    });
+}
+
+// -----------------------------------------------------------------------------
+// Streaming de trozos (laberintos grandes)
+// -----------------------------------------------------------------------------
+// Un laberinto de STREAM_MIN_CELLS celdas o más no se hornea entero al cargar:
+// el nivel trae solo el foyer y la sala final, y los muros se hornean por
+// trozos de STREAM_CHUNK_CELLS x STREAM_CHUNK_CELLS celdas en un hilo de fondo,
+// cada uno con sus cajas, su malla y su rejilla de colisión. Cada frame el
+// render pide los trozos a g_StreamRadius de la cámara (los más cercanos
+// primero), sube unos pocos y descarga los que quedan lejos o no caben en
+// g_StreamBudgetBytes. Sin PVS: los trozos se descartan solo por frustum.
+
+static const int STREAM_UPLOADS_PER_FRAME = 2;
+
+// Trozo horneado en el hilo de fondo, pendiente de subir a GL
+struct StreamBake {
+    int chunk = 0;
+    unsigned generation = 0;
+    std::vector<LevelVertex> wallVerts;
+    std::vector<float> edgeVerts;
+    std::vector<LevelChunk> parts;
+    std::shared_ptr<const StreamCollision> collision;
+};
+
+struct StreamJob {
+    int chunk;
+    unsigned generation;
+    std::shared_ptr<const BitGrid> maze;
+};
+
+static std::mutex g_StreamMutex;                   // cola de trabajos y horneados
+static std::condition_variable g_StreamWake;
+static std::deque<StreamJob> g_StreamJobs;         // más cercanos delante
+static std::vector<std::unique_ptr<StreamBake>> g_StreamDone;
+static bool g_StreamQuit = false;
+static std::thread g_StreamThread;
+
+// Solo render: horneados recogidos que aún no se han subido
+static std::vector<std::unique_ptr<StreamBake>> g_StreamReady;
+
+// Cajas, malla y colisión de un trozo. Solo CPU. Las caras ocultas se miran en
+// el laberinto completo, también al otro lado del borde del trozo.
+static std::unique_ptr<StreamBake> bakeStreamChunk(const StreamJob& job)
+{
+    PROFILE_SCOPE("bakeStreamChunk");
+    const BitGrid& maze = *job.maze;
+    const int chunksX = (maze.Width() + STREAM_CHUNK_CELLS - 1) / STREAM_CHUNK_CELLS;
+    const int x0 = (job.chunk % chunksX) * STREAM_CHUNK_CELLS;
+    const int z0 = (job.chunk / chunksX) * STREAM_CHUNK_CELLS;
+    const int w = std::min(STREAM_CHUNK_CELLS, maze.Width() - x0);
+    const int h = std::min(STREAM_CHUNK_CELLS, maze.Height() - z0);
+
+    BitGrid local(w, h);
+    for (int z = 0; z < h; ++z)
+        for (int x = 0; x < w; ++x)
+            if (maze.Get(x0 + x, z0 + z))
+                local.Set(x, z, true);
+
+    std::vector<Rect> rects;
+    RectCover_Build(local, g_RectCoverMode, rects);
+    for (Rect& r : rects) {
+        r.x += x0;
+        r.z += z0;
+    }
+
+    auto bake = std::make_unique<StreamBake>();
+    bake->chunk = job.chunk;
+    bake->generation = job.generation;
+
+    // Partes de CHUNK_CELLS celdas para el frustum, como en bakeLevelMesh()
+    const int parts = STREAM_CHUNK_CELLS / CHUNK_CELLS;
+    std::vector<std::vector<int>> buckets((size_t)parts * parts);
+    for (int i = 0; i < (int)rects.size(); ++i) {
+        const Rect& r = rects[i];
+        const int px = std::min((2 * (r.x - x0) + r.w) / (2 * CHUNK_CELLS), parts - 1);
+        const int pz = std::min((2 * (r.z - z0) + r.l) / (2 * CHUNK_CELLS), parts - 1);
+        buckets[(size_t)pz * parts + px].push_back(i);
+    }
+
+    for (const auto& bucket : buckets) {
+        if (bucket.empty())
+            continue;
+
+        LevelChunk c;
+        c.firstVert = (int)bake->wallVerts.size();
+        c.firstEdge = (int)bake->edgeVerts.size() / 3;
+        c.bounds = { FLT_MAX, 0.0f, FLT_MAX, -FLT_MAX, wallH, -FLT_MAX };
+        for (int i : bucket) {
+            const Rect& r = rects[i];
+            const AABB b = wallBoxFromRect(r);
+            bakeBeveledBox(maze, bake->wallVerts, bake->edgeVerts,
+                b.minx, b.minz, b.maxx - b.minx, wallH, b.maxz - b.minz, 0.12f, &r);
+            c.bounds.minx = std::min(c.bounds.minx, b.minx);
+            c.bounds.minz = std::min(c.bounds.minz, b.minz);
+            c.bounds.maxx = std::max(c.bounds.maxx, b.maxx);
+            c.bounds.maxz = std::max(c.bounds.maxz, b.maxz);
+        }
+        c.vertCount = (int)bake->wallVerts.size() - c.firstVert;
+        c.edgeCount = (int)bake->edgeVerts.size() / 3 - c.firstEdge;
+        bake->parts.push_back(c);
+    }
+
+    auto coll = std::make_shared<StreamCollision>();
+    coll->walls.reserve(rects.size());
+    for (const Rect& r : rects)
+        coll->walls.push_back(wallBoxFromRect(r));
+    buildCollisionGrid(coll->walls, coll->grid);
+    bake->collision = std::move(coll);
+    return bake;
+}
 
-    // cinco muros del foyer
-    extraWalls.emplace_back(MakeAABB(sx0, 0.0f, sz1 - eps, cx0, wallH, sz1 + eps));
-    extraWalls.emplace_back(MakeAABB(cx1, 0.0f, sz1 - eps, sx1, wallH, sz1 + eps));
-    extraWalls.emplace_back(MakeAABB(sx0 - eps, 0.0f, sz0, sx0 + eps, wallH, sz1));
-    extraWalls.emplace_back(MakeAABB(sx1 - eps, 0.0f, sz0, sx1 + eps, wallH, sz1));
-    extraWalls.emplace_back(MakeAABB(sx0, 0.0f, sz0 - eps, sx1, wallH, sz0 + eps));
+static void streamWorkerLoop()
+{
+    Profiler_SetThreadName("Streaming de trozos");
+    std::unique_lock<std::mutex> lock(g_StreamMutex);
+    for (;;) {
+        g_StreamWake.wait(lock, [] { return g_StreamQuit || !g_StreamJobs.empty(); });
+        if (g_StreamQuit)
+            return;
 
-    // paredes del pasillo
-    extraWalls.emplace_back(MakeAABB(cx0 - eps, 0.0f, cz0, cx0 + eps, wallH, cz1));
-    extraWalls.emplace_back(MakeAABB(cx1 - eps, 0.0f, cz0, cx1 + eps, wallH, cz1));
+        StreamJob job = std::move(g_StreamJobs.front());
+        g_StreamJobs.pop_front();
+        lock.unlock();
+        std::unique_ptr<StreamBake> bake = bakeStreamChunk(job);
+        lock.lock();
+        g_StreamDone.push_back(std::move(bake));
+    }
+}
 
-    walls.insert(walls.end(), extraWalls.begin(), extraWalls.end());
+static void stopStreamWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(g_StreamMutex);
+        g_StreamQuit = true;
+    }
+    g_StreamWake.notify_one();
+    if (g_StreamThread.joinable())
+        g_StreamThread.join();
 }
 
-void drawFoyerCorridorFloors() {
-    const float sx0 = START_CX() - 0.5f * START_W;
-    const float sx1 = START_CX() + 0.5f * START_W;
-    const float sz0 = START_CZ() - 0.5f * START_D;
-    const float sz1 = START_CZ() + 0.5f * START_D;
+// Memoria que ocupa un trozo residente: vértices (ya en las display lists) y
+// colisión
+static size_t streamBakeBytes(const StreamBake& b)
+{
+    const StreamCollision& c = *b.collision;
+    return b.wallVerts.size() * sizeof(LevelVertex) + b.edgeVerts.size() * sizeof(float)
+        + b.parts.size() * sizeof(LevelChunk) + c.walls.size() * sizeof(AABB)
+        + (c.grid.cellStart.size() + c.grid.cellWalls.size()) * sizeof(int);
+}
 
-    const float corridorHalf = 0.5f * CORRIDOR_W;
-    const float cx0 = START_CX() - corridorHalf;
-    const float cx1 = START_CX() + corridorHalf;
-    const float cz0 = sz1;
-    const float cz1 = 0.0f;
+static void uploadStreamChunk(StreamBake& b)
+{
+    StreamChunk& sc = g_Stream.chunks[b.chunk];
+    sc.bytes = streamBakeBytes(b);
+    sc.parts = std::move(b.parts);
+    sc.bounds = { FLT_MAX, 0.0f, FLT_MAX, -FLT_MAX, wallH, -FLT_MAX };
+    for (const LevelChunk& c : sc.parts) {
+        sc.bounds.minx = std::min(sc.bounds.minx, c.bounds.minx);
+        sc.bounds.minz = std::min(sc.bounds.minz, c.bounds.minz);
+        sc.bounds.maxx = std::max(sc.bounds.maxx, c.bounds.maxx);
+        sc.bounds.maxz = std::max(sc.bounds.maxz, c.bounds.maxz);
+    }
+    if (!sc.parts.empty()) {
+        sc.lists = glGenLists(2 * (GLsizei)sc.parts.size());
+        compileChunkLists(sc.lists, sc.parts, b.wallVerts, b.edgeVerts);
+    }
+    std::atomic_store(&sc.collision, b.collision);
+    sc.state = StreamState::Resident;
 
-    drawDarkFloorArea(sx0, sz0, sx1, sz1); // foyer
-    drawDarkFloorArea(cx0, cz0, cx1, cz1); // pasillo
+    StreamStats& st = g_Stream.stats;
+    st.residentBytes += sc.bytes;
+    ++st.residentChunks;
+    ++st.loads;
 }
 
-// -----------------------------------------------------------------------------
-// Colisiones
-// -----------------------------------------------------------------------------
+static void unloadStreamChunk(StreamChunk& sc)
+{
+    if (sc.state == StreamState::Resident) {
+        if (sc.lists)
+            glDeleteLists(sc.lists, 2 * (GLsizei)sc.parts.size());
+        std::atomic_store(&sc.collision, std::shared_ptr<const StreamCollision>());
+
+        StreamStats& st = g_Stream.stats;
+        st.residentBytes -= sc.bytes;
+        --st.residentChunks;
+        ++st.unloads;
+    }
+    sc.lists = 0;
+    sc.parts = std::vector<LevelChunk>();
+    sc.bytes = 0;
+    sc.state = StreamState::Unloaded;
+}
 
-bool collideXZ(float nx, float nz, float radius) {
-    for (const auto& w : walls) {
-        float cx = clampf(nx, w.minx, w.maxx);
-        float cz = clampf(nz, w.minz, w.maxz);
-        float dx = nx - cx, dz = nz - cz;
-        if (dx * dx + dz * dz < radius * radius) return true;
+// Al activar un nivel (hilo de GL, con la simulación esperando): descarta los
+// trozos del anterior y prepara la tabla del nuevo si va por trozos
+static void resetStreaming()
+{
+    for (int i : g_Stream.live)
+        unloadStreamChunk(g_Stream.chunks[i]);
+    {
+        std::lock_guard<std::mutex> lock(g_StreamMutex);
+        g_StreamJobs.clear();
+        g_StreamDone.clear();
+    }
+    g_StreamReady.clear();
+
+    ++g_Stream.generation;
+    g_Stream.chunks.clear();
+    g_Stream.live.clear();
+    g_Stream.maze.reset();
+    g_Stream.camChunk = -1;
+    g_Stream.chunksX = g_Stream.chunksZ = 0;
+    g_Stream.stats = StreamStats();
+    if (!g_Level.streamed)
+        return;
+
+    g_Stream.chunksX = (g_Level.mapW + STREAM_CHUNK_CELLS - 1) / STREAM_CHUNK_CELLS;
+    g_Stream.chunksZ = (g_Level.mapH + STREAM_CHUNK_CELLS - 1) / STREAM_CHUNK_CELLS;
+    g_Stream.chunks.resize((size_t)g_Stream.chunksX * g_Stream.chunksZ);
+    g_Stream.maze = std::make_shared<const BitGrid>(g_Level.maze);
+    g_Stream.stats.active = true;
+    g_Stream.stats.radius = g_StreamRadius;
+
+    if (!g_StreamThread.joinable()) {
+        g_StreamThread = std::thread(streamWorkerLoop);
+        std::atexit(stopStreamWorker);
     }
-    return false;
 }
 
-bool collideY(float x, float y, float z, float radius, float height) {
-    AABB p{ x - radius, y - 0.1f, z - radius,
-            x + radius, y + height, z + radius };
-    for (const auto& w : walls) {
-        bool o = !(p.maxx <= w.minx || p.minx >= w.maxx ||
-            p.maxy <= w.miny || p.miny >= w.maxy ||
-            p.maxz <= w.minz || p.minz >= w.maxz);
-        if (o) return true;
+// Cada frame en el render, con la posición de la cámara de la instantánea
+static void updateStreaming(float x, float z)
+{
+    if (!g_Level.streamed)
+        return;
+    PROFILE_SCOPE("updateStreaming");
+    StreamStats& st = g_Stream.stats;
+    const int chunksX = g_Stream.chunksX;
+
+    // Trozo de la cámara; desde el foyer o la sala final, el del borde
+    const int camTx = std::clamp(collCellOf(x), 0, g_Level.mapW - 1) / STREAM_CHUNK_CELLS;
+    const int camTz = std::clamp(collCellOf(z), 0, g_Level.mapH - 1) / STREAM_CHUNK_CELLS;
+    auto distance = [&](int i) {
+        return std::max(std::abs(i % chunksX - camTx), std::abs(i / chunksX - camTz));
+    };
+
+    // 1) Subir lo horneado, el más cercano primero. Lo que llega de otro nivel
+    // o de un trozo que ya no se quiere se tira.
+    {
+        std::lock_guard<std::mutex> lock(g_StreamMutex);
+        for (auto& b : g_StreamDone)
+            g_StreamReady.push_back(std::move(b));
+        g_StreamDone.clear();
     }
-    return false;
+    auto stale = [](const std::unique_ptr<StreamBake>& b) {
+        return b->generation != g_Stream.generation
+            || g_Stream.chunks[b->chunk].state != StreamState::Queued;
+    };
+    const size_t ready = g_StreamReady.size();
+    g_StreamReady.erase(std::remove_if(g_StreamReady.begin(), g_StreamReady.end(), stale),
+        g_StreamReady.end());
+    st.dropped += (int)(ready - g_StreamReady.size());
+
+    std::sort(g_StreamReady.begin(), g_StreamReady.end(),
+        [&](const auto& a, const auto& b) { return distance(a->chunk) > distance(b->chunk); });
+    for (int n = 0; n < STREAM_UPLOADS_PER_FRAME && !g_StreamReady.empty(); ++n) {
+        uploadStreamChunk(*g_StreamReady.back());
+        g_StreamReady.pop_back();
+    }
+
+    // 2) Radio efectivo: el mayor que quepa en el presupuesto con el tamaño
+    // medio de los trozos ya cargados; nunca menos de los 3x3 de alrededor
+    int radius = g_StreamRadius;
+    if (st.residentChunks > 0) {
+        const size_t avg = st.residentBytes / st.residentChunks;
+        while (radius > 1 && (size_t)(2 * radius + 1) * (2 * radius + 1) * avg > g_StreamBudgetBytes)
+            --radius;
+    }
+    st.radius = radius;
+
+    // 3) Descargar lo que queda a más de radius + 1 (un trozo de margen para
+    // no cargar y descargar en bucle al ir y venir por un borde) y, si aún
+    // se pasa del presupuesto, los residentes más lejanos fuera de los 3x3
+    std::vector<int>& live = g_Stream.live;
+    std::vector<int> cancelled;
+    for (int i : live) {
+        if (distance(i) <= radius + 1)
+            continue;
+        if (g_Stream.chunks[i].state == StreamState::Queued)
+            cancelled.push_back(i);
+        unloadStreamChunk(g_Stream.chunks[i]);
+    }
+    if (st.residentBytes > g_StreamBudgetBytes) {
+        std::sort(live.begin(), live.end(), [&](int a, int b) { return distance(a) > distance(b); });
+        for (int i : live) {
+            if (st.residentBytes <= g_StreamBudgetBytes || distance(i) <= 1)
+                break;
+            if (g_Stream.chunks[i].state == StreamState::Resident)
+                unloadStreamChunk(g_Stream.chunks[i]);
+        }
+    }
+    live.erase(std::remove_if(live.begin(), live.end(),
+        [](int i) { return g_Stream.chunks[i].state == StreamState::Unloaded; }), live.end());
+
+    // 4) Pedir los que faltan dentro del radio, por anillos desde la cámara
+    std::vector<int> wanted;
+    for (int d = 0; d <= radius; ++d)
+        for (int tz = camTz - d; tz <= camTz + d; ++tz)
+            for (int tx = camTx - d; tx <= camTx + d; ++tx) {
+                if (std::max(std::abs(tx - camTx), std::abs(tz - camTz)) != d)
+                    continue;
+                if (tx < 0 || tz < 0 || tx >= chunksX || tz >= g_Stream.chunksZ)
+                    continue;
+                const int i = tz * chunksX + tx;
+                if (g_Stream.chunks[i].state != StreamState::Unloaded)
+                    continue;
+                // Los que ya pasan del presupuesto esperan, salvo los 3x3
+                if (d > 1 && st.residentBytes > g_StreamBudgetBytes)
+                    continue;
+                g_Stream.chunks[i].state = StreamState::Queued;
+                live.push_back(i);
+                wanted.push_back(i);
+            }
+
+    const int camChunk = camTz * chunksX + camTx;
+    if (!wanted.empty() || !cancelled.empty() || camChunk != g_Stream.camChunk) {
+        {
+            std::lock_guard<std::mutex> lock(g_StreamMutex);
+            if (!cancelled.empty()) {
+                g_StreamJobs.erase(std::remove_if(g_StreamJobs.begin(), g_StreamJobs.end(),
+                    [](const StreamJob& j) { return g_Stream.chunks[j.chunk].state != StreamState::Queued; }),
+                    g_StreamJobs.end());
+            }
+            for (int i : wanted)
+                g_StreamJobs.push_back({ i, g_Stream.generation, g_Stream.maze });
+            std::stable_sort(g_StreamJobs.begin(), g_StreamJobs.end(),
+                [&](const StreamJob& a, const StreamJob& b) { return distance(a.chunk) < distance(b.chunk); });
+        }
+        if (!wanted.empty())
+            g_StreamWake.notify_one();
+        g_Stream.camChunk = camChunk;
+    }
+
+    st.queuedChunks = (int)live.size() - st.residentChunks;
+
+    Profiler_SetCounter("Trozos residentes", st.residentChunks);
+    Profiler_SetCounter("Trozos en cola", st.queuedChunks);
+    Profiler_SetCounter("Memoria trozos (MB)", st.residentBytes / (1024.0 * 1024.0));
+    Profiler_SetCounter("Radio (trozos)", st.radius);
+    Profiler_SetCounter("Cargas", st.loads);
+    Profiler_SetCounter("Descargas", st.unloads);
 }
 
 // -----------------------------------------------------------------------------
@@ -1067,17 +2709,21 @@ bool collideY(float x, float y, float z, float radius, float height) {
 // -----------------------------------------------------------------------------
 
 void setCamera() {
-    float cosP = cosf(pitch), sinP = sinf(pitch);
-    float cosY = cosf(yaw), sinY = sinf(yaw);
+    float cosP = cosf(g_View.pitch), sinP = sinf(g_View.pitch);
+    float cosY = cosf(g_View.yaw), sinY = sinf(g_View.yaw);
     float dirX = cosP * cosY;
     float dirY = sinP;
     float dirZ = cosP * sinY;
 
     glLoadIdentity();
-    gluLookAt(camX, camY, camZ,
-        camX + dirX, camY + dirY, camZ + dirZ,
+    gluLookAt(renderCamX, renderCamY, renderCamZ,
+        renderCamX + dirX, renderCamY + dirY, renderCamZ + dirZ,
         0, 1, 0);
 
+    const float eye[3] = { renderCamX, renderCamY, renderCamZ };
+    const float dir[3] = { dirX, dirY, dirZ };
+    buildViewFrustum(g_ViewFrustum, eye, dir, CAMERA_FOV_Y, g_CameraAspect, CAMERA_NEAR, CAMERA_FAR);
+
     GLfloat lightPos[] = { 0.0f, 10.0f, 0.0f, 1.0f };
     glLightfv(GL_LIGHT0, GL_POSITION, lightPos);
 }
@@ -1204,6 +2850,7 @@ static void DrawLivesHUD()
 // NARRADOR HUD
 static void DrawNarratorHUD()
 {
+    PROFILE_SCOPE("DrawNarratorHUD");
     if (g_SrxFullLine.empty())
         return;
 
@@ -1397,16 +3044,16 @@ static void DrawNarratorHUD()
 
 static void DrawScreenFade()
 {
-    if (g_TransitionState == TransitionState::NONE)
+    if (g_View.transition == TransitionState::NONE)
         return;
 
-    float t = clampf(g_TransitionTime / TRANSITION_TOTAL, 0.0f, 1.0f);
+    float t = clampf(g_View.transitionTime / TRANSITION_TOTAL, 0.0f, 1.0f);
     float alpha = 0.0f;
 
-    if (g_TransitionState == TransitionState::FADING_OUT) {
+    if (g_View.transition == TransitionState::FADING_OUT) {
         alpha = t;               // negro de 0 → 1
     }
-    else if (g_TransitionState == TransitionState::FADING_IN) {
+    else if (g_View.transition == TransitionState::FADING_IN) {
         alpha = 1.0f - t;        // negro de 1 → 0
     }
 
@@ -1448,7 +3095,7 @@ static void DrawScreenFade()
 
 static void DrawPauseOverlay()
 {
-    if (!g_Paused)
+    if (!g_View.paused)
         return;
 
     // Configurar proyección en 2D
@@ -1554,6 +3201,7 @@ static void DrawPauseOverlay()
 // -----------------------------------------------------------------------------
 
 void drawMaze() {
+    PROFILE_SCOPE("drawMaze");
     glDisable(GL_CULL_FACE);
     glDepthMask(GL_TRUE);
     glDisable(GL_BLEND);
@@ -1563,22 +3211,25 @@ void drawMaze() {
     if (g_WorldStage >= 4)
     {
         const float centerX = ENTRANCE_CX();
-        const float labEndZ = MAP_H * CELL;
+        const float labEndZ = g_Level.mapH * CELL;
         const float roomD = 3.0f * CELL;
 
         const float portalZ = labEndZ + 0.5f * roomD;
         const float portalY = 1.2f;
 
+        markPhase(RenderPhase::Portal);
         drawPortal(centerX, portalY, portalZ);
         return;
     }
 
     // --- Suelos ---
-    drawDarkFloorArea(0.0f, 0.0f, MAP_W * CELL, MAP_H * CELL);
+    markPhase(RenderPhase::Floors);
+    drawDarkFloorArea(0.0f, 0.0f, g_Level.mapW * CELL, g_Level.mapH * CELL);
     drawFoyerCorridorFloors();
     drawEndRoomFloor();
 
     // --- Muros ---
+    markPhase(RenderPhase::Walls);
     const GLfloat noSpec[] = { 0.0f, 0.0f, 0.0f, 1.0f };
 
     if (g_WorldStage == 0)
@@ -1615,27 +3266,18 @@ void drawMaze() {
         glMaterialf(GL_FRONT, GL_SHININESS, 0.0f);
     }
 
-    // Muros del laberinto
-    for (auto& r : wallRects) {
-        glPushMatrix();
-        glTranslatef(r.x * CELL, 0.0f, r.z * CELL);
-        drawBeveledBox(r.w * CELL, wallH, r.l * CELL, 0.12f);
-        glPopMatrix();
-    }
-
-    // Muros extra
-    for (auto& w : extraWalls)
-        drawAABB_AsBeveled(w, 0.12f);
-    for (auto& w : decorWalls)
-        drawAABB_AsBeveled(w, 0.12f);
+    // Muros del laberinto + extra + decorado (malla horneada en LoadLevelData)
+    drawLevelMesh();
 
     // Prismas verdes (solo mientras existan muros/suelo)
+    markPhase(RenderPhase::Prisms);
     drawGreenDiamondsInCorridor();
 
     // Portal en la sala final
+    markPhase(RenderPhase::Portal);
     {
         const float centerX = ENTRANCE_CX();
-        const float labEndZ = MAP_H * CELL;
+        const float labEndZ = g_Level.mapH * CELL;
         const float roomD = 3.0f * CELL;
 
         const float portalZ = labEndZ + 0.5f * roomD;
@@ -1659,7 +3301,7 @@ int World_GetTouchedPrismIndex()
 
     for (int i = 0; i < (int)greenPrisms.size(); ++i)
     {
-        if (i < (int)greenPrismActive.size() && !greenPrismActive[i])
+        if (i < (int)g_SimPrismActive.size() && !g_SimPrismActive[i])
             continue;
 
         const auto& c = greenPrisms[i];
@@ -1688,6 +3330,8 @@ void World_DisablePrism(int index)
         greenPrismActive.resize(greenPrisms.size(), true);
 
     greenPrismActive[index] = false;
+    g_PrismBatchDirty = true;
+    pushSimInput(WorldInput::PRISM_DISABLED, index);
 }
 
 // Llamado por puzzles cuando el jugador falla una verificación
@@ -1698,13 +3342,9 @@ int World_OnPuzzleFailed()
     if (g_PlayerLives > 0)
         --g_PlayerLives;   // quitar un corazón
 
-    // Bloquear sprint de forma permanente
-    g_SprintBlocked = true;
-    sprint = false;
-
-    if (g_PlayerLives == 1) {
-        g_InvertControls = true;
-    }
+    // Sprint bloqueado para siempre y, con la última vida, controles
+    // invertidos: eso lo aplica la simulación
+    pushSimInput(WorldInput::PUZZLE_PENALTY, g_PlayerLives == 1 ? 1 : 0);
 
     return g_PlayerLives;
 }
@@ -1795,43 +3435,37 @@ void World_Init()
     // ----------------------------------------
     // Crear quadrics necesarios
     // ----------------------------------------
-    if (!gQuadricSky) {
-        gQuadricSky = gluNewQuadric();
-        gluQuadricTexture(gQuadricSky, GL_TRUE);
-        gluQuadricNormals(gQuadricSky, GLU_NONE);
-    }
-
     if (!gQuadricSphere) {
         gQuadricSphere = gluNewQuadric();
         gluQuadricTexture(gQuadricSphere, GL_FALSE);
         gluQuadricNormals(gQuadricSphere, GLU_SMOOTH);
     }
+    buildPrismMesh();
 
     // Orientación del panorama equirectangular
-    skyFlipV = true;
-    skyYawDeg = 90.0f;
-    skyPitchDeg = 270.0f;
-    skyRollDeg = 90.0f;
+    skyOrient.flipV = true;
+    skyOrient.yawDeg = 90.0f;
+    skyOrient.pitchDeg = 270.0f;
+    skyOrient.rollDeg = 90.0f;
 
     // ----------------------------------------
     // Cargar el nivel actual (EASY por defecto)
     // ----------------------------------------
+    TextureCache_SetBudget(TEXTURE_VRAM_BUDGET_MB * 1024 * 1024);
     LoadLevelData();
     // Esto ya:
-    // - copia mazeEasy → maze
-    // - pone rombos rojos
+    // - carga levels/easy.lvl → maze (o el laberinto integrado)
+    // - pone rombos rojos y el spawn del nivel
     // - carga wall1 + panoramaEasy
     // - reconstruye paredes + foyer + endroom
 
     // ----------------------------------------
     // Spawn del jugador
     // ----------------------------------------
-    PLAYER_SPAWN_X = START_CX();
-    PLAYER_SPAWN_Z = START_CZ() + 0.25f * START_D;
-
     camX = PLAYER_SPAWN_X;
     camZ = PLAYER_SPAWN_Z;
     camY = PLAYER_Y_EYE;
+    snapCameraInterpolation();
 
     yaw = 0.0f;
     pitch = 0.0f;
@@ -1845,6 +3479,8 @@ void World_Init()
 // ----------------------------------------
     SetupSrxWelcomeForCurrentLevel();
 
+    g_SimPrismActive.assign(greenPrisms.size(), true);
+    publishWorldState();
 }
 
 
@@ -1861,9 +3497,10 @@ void World_OnResize(int w, int h)
     winH = h;
     if (h == 0) h = 1;
     glViewport(0, 0, w, h);
+    g_CameraAspect = (float)w / (float)h;
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
-    gluPerspective(70.0, (double)w / (double)h, 0.05, 400.0);
+    gluPerspective(CAMERA_FOV_Y, g_CameraAspect, CAMERA_NEAR, CAMERA_FAR);
     glMatrixMode(GL_MODELVIEW);
 }
 
@@ -1877,6 +3514,20 @@ void World_OnKeyDown(unsigned char k, int, int)
     if (Puzzles_IsOpen())
         return;
 
+    pushSimInput(WorldInput::KEY_DOWN, k, glutGet(GLUT_ELAPSED_TIME));
+}
+
+void World_OnKeyUp(unsigned char k, int, int)
+{
+    if (Puzzles_IsOpen())
+        return;
+
+    pushSimInput(WorldInput::KEY_UP, k);
+}
+
+// Hilo de simulación
+static void simKeyDown(unsigned char k, int now)
+{
     if (k == 27) {
         g_Paused = !g_Paused;
         return;
@@ -1884,10 +3535,7 @@ void World_OnKeyDown(unsigned char k, int, int)
 
     keys[k] = true;
 
-    keys[k] = true;
-
     if (k == 'w' || k == 'W') {
-        int now = glutGet(GLUT_ELAPSED_TIME);
         if (!wIsDown) {
             if (!g_SprintBlocked && (now - lastWTapMs <= SPRINT_DOUBLE_TAP_MS))
                 sprint = true;
@@ -1903,11 +3551,8 @@ void World_OnKeyDown(unsigned char k, int, int)
     }
 }
 
-void World_OnKeyUp(unsigned char k, int, int)
+static void simKeyUp(unsigned char k)
 {
-    if (Puzzles_IsOpen())
-        return;
-
     keys[k] = false;
     if (k == 'w' || k == 'W') {
         wIsDown = false;
@@ -1930,20 +3575,15 @@ void World_OnSpecialKey(int key, int, int)
             glutPositionWindow((screenW - winW) / 2, (screenH - winH) / 2);
         }
     }
+    // Cambio de nivel: la simulación se detiene y pide la carga al render
     else if (key == GLUT_KEY_F1) {
-        g_CurrentLevel = LevelDifficulty::EASY;
-        LoadLevelData();
+        pushSimInput(WorldInput::LOAD_LEVEL, (int)LevelDifficulty::EASY);
     }
     else if (key == GLUT_KEY_F3) {
-        g_CurrentLevel = LevelDifficulty::HARD;
-        LoadLevelData();
+        pushSimInput(WorldInput::LOAD_LEVEL, (int)LevelDifficulty::HARD);
     }
     else if (key == GLUT_KEY_F2) {
-        g_CurrentLevel = LevelDifficulty::MEDIUM;
-        LoadLevelData();
-
-        // En nivel medio no queremos texto del narrador SRX
-        World_SetNarratorLine("", 0);
+        pushSimInput(WorldInput::LOAD_LEVEL, (int)LevelDifficulty::MEDIUM);
     }
 }
 
@@ -1967,7 +3607,7 @@ void World_OnMouseMotion(int x, int y)
 {
     if (!mouseCaptured) return;
     if (Puzzles_IsOpen()) return;
-    if (g_Paused) return;
+    if (g_View.paused) return;
 
     int cx = winW / 2;
     int cy = winH / 2;
@@ -1976,6 +3616,15 @@ void World_OnMouseMotion(int x, int y)
     int dy = y - cy;
     if (dx == 0 && dy == 0) return;
 
+    pushSimInput(WorldInput::MOUSE_LOOK, dx, dy);
+
+    glutWarpPointer(cx, cy);
+    glutPostRedisplay();
+}
+
+// Hilo de simulación
+static void simMouseLook(int dx, int dy)
+{
     yaw += dx * mouseSens;
     pitch -= dy * mouseSens;
 
@@ -1985,53 +3634,97 @@ void World_OnMouseMotion(int x, int y)
 
     if (yaw > M_PI) yaw -= (float)(2 * M_PI);
     if (yaw < -M_PI) yaw += (float)(2 * M_PI);
+}
 
-    glutWarpPointer(cx, cy);
-    glutPostRedisplay();
+// Nivel activado por el render (fin del fade o F1/F2/F3)
+static void simLevelCommitted()
+{
+    g_SimAwaitingLevel = false;
+    g_SimPrismActive.assign(greenPrisms.size(), true);
+
+    if (g_TransitionState != TransitionState::FADING_OUT)
+        return;
+
+    // Respawn al inicio del laberinto correspondiente
+    camX = PLAYER_SPAWN_X;
+    camZ = PLAYER_SPAWN_Z;
+    camY = PLAYER_Y_EYE;
+    snapCameraInterpolation();
+
+    yaw = 0.0f;
+    pitch = 0.0f;
+    velY = 0.0f;
+    onGround = true;
+
+    // limpiar input
+    std::memset(keys, 0, sizeof(keys));
+    sprint = false;
+    wIsDown = false;
+
+    // Pasamos a FADING_IN
+    g_TransitionState = TransitionState::FADING_IN;
+    g_TransitionTime = 0.0f;
+}
+
+static void applySimInput(const WorldInput& ev)
+{
+    switch (ev.type) {
+    case WorldInput::KEY_DOWN:
+        simKeyDown((unsigned char)ev.a, ev.b);
+        break;
+    case WorldInput::KEY_UP:
+        simKeyUp((unsigned char)ev.a);
+        break;
+    case WorldInput::MOUSE_LOOK:
+        simMouseLook(ev.a, ev.b);
+        break;
+    case WorldInput::PUZZLE_CLOSED:
+        g_SimPuzzleOpen = false;
+        break;
+    case WorldInput::PRISM_DISABLED:
+        if (ev.a >= 0 && ev.a < (int)g_SimPrismActive.size())
+            g_SimPrismActive[ev.a] = false;
+        break;
+    case WorldInput::PUZZLE_PENALTY:
+        // Bloquear sprint de forma permanente
+        g_SprintBlocked = true;
+        sprint = false;
+        if (ev.a)
+            g_InvertControls = true;
+        break;
+    case WorldInput::LOAD_LEVEL:
+        if (g_TransitionState == TransitionState::NONE && !g_SimAwaitingLevel) {
+            g_SimAwaitingLevel = true;
+            pushSimCommand(WorldCommand::LOAD_LEVEL_NOW, ev.a);
+        }
+        break;
+    case WorldInput::LEVEL_READY:
+        g_SimLevelReady = true;
+        break;
+    case WorldInput::LEVEL_COMMITTED:
+        simLevelCommitted();
+        break;
+    }
 }
 
 // -----------------------------------------------------------------------------
-// Update del mundo (llamado desde timer en main.cpp)
+// Update del mundo (un paso fijo de física en el hilo de simulación)
 // -----------------------------------------------------------------------------
 
-void World_Update(int ms)
+static void stepSimulation(float dt)
 {
     // --- manejar transición global (fade + cambio de nivel) ---
     if (g_TransitionState != TransitionState::NONE)
     {
-        float dt = ms / 1000.0f;
         g_TransitionTime += dt;
 
         if (g_TransitionState == TransitionState::FADING_OUT) {
-            if (g_TransitionTime >= TRANSITION_TOTAL) {
-                // Cambiamos al nivel objetivo (MEDIUM o HARD)
-                g_CurrentLevel = g_TransitionTargetLevel;
-                LoadLevelData();
-
-                // Respawn al inicio del laberinto correspondiente
-                PLAYER_SPAWN_X = START_CX();
-                PLAYER_SPAWN_Z = START_CZ() + 0.25f * START_D;
-
-                camX = PLAYER_SPAWN_X;
-                camZ = PLAYER_SPAWN_Z;
-                camY = PLAYER_Y_EYE;
-
-                yaw = 0.0f;
-                pitch = 0.0f;
-                velY = 0.0f;
-                onGround = true;
-
-                // limpiar input
-                std::memset(keys, 0, sizeof(keys));
-                sprint = false;
-                wIsDown = false;
-
-                // Volvemos a configurar la línea de SRX según el nuevo nivel
-                SetupSrxWelcomeForCurrentLevel();
-
-                // Pasamos a FADING_IN
-                g_TransitionState = TransitionState::FADING_IN;
-                g_TransitionTime = 0.0f;
+            // El render prepara el nivel objetivo desde que empezó el fade;
+            // cuando avisa de que está subido, le pedimos que lo active y
+            // seguimos en simLevelCommitted().
+            if (g_TransitionTime >= TRANSITION_TOTAL && g_SimLevelReady && !g_SimAwaitingLevel) {
+                pushSimCommand(WorldCommand::COMMIT_LEVEL);
+                g_SimAwaitingLevel = true;
             }
         }
 
@@ -2046,12 +3739,11 @@ void World_Update(int ms)
         // Mientras hay transición, bloqueamos movimiento/jugador
         return;
     }
-    // Si el puzzle está abierto, no integramos físicas ni movimiento
-    if (Puzzles_IsOpen())
+    // Si el puzzle está abierto o cambia el nivel, no integramos físicas
+    if (g_SimPuzzleOpen || g_SimAwaitingLevel)
         return;
     if (g_Paused)
         return;
-    float dt = ms / 1000.0f;
 
     if (!(keys['w'] || keys['W']))
         sprint = false;
@@ -2108,13 +3800,10 @@ void World_Update(int ms)
     int  prismIndex = World_GetTouchedPrismIndex();
     bool touching = (prismIndex >= 0);
 
-    if (touching && !wasTouching) {
-        // Abrir puzzle asociado a ese prisma
-        Puzzles_OpenForPrism(prismIndex);
-
-        // soltar ratón
-        mouseCaptured = false;
-        glutSetCursor(GLUT_CURSOR_LEFT_ARROW);
+    if (touching && !wasTouching && !g_BenchmarkMode) {
+        // Abrir puzzle asociado a ese prisma (ImGui: lo hace el render)
+        pushSimCommand(WorldCommand::OPEN_PUZZLE, prismIndex);
+        g_SimPuzzleOpen = true;
 
         // limpiar entrada
         std::memset(keys, 0, sizeof(keys));
@@ -2125,10 +3814,10 @@ void World_Update(int ms)
 
     wasTouching = touching;
 
-    if (g_TransitionState == TransitionState::NONE)
+    if (g_TransitionState == TransitionState::NONE && !g_BenchmarkMode)
     {
         const float centerX = ENTRANCE_CX();
-        const float labEndZ = MAP_H * CELL;
+        const float labEndZ = g_Level.mapH * CELL;
         const float roomD = 3.0f * CELL;
 
         const float portalX = centerX;
@@ -2154,6 +3843,8 @@ void World_Update(int ms)
 
             g_TransitionState = TransitionState::FADING_OUT;
             g_TransitionTime = 0.0f;
+            g_SimLevelReady = false;
+            pushSimCommand(WorldCommand::START_LEVEL_LOAD, (int)g_TransitionTargetLevel);
 
             // Limpiar entrada / estados de movimiento
             std::memset(keys, 0, sizeof(keys));
@@ -2164,23 +3855,170 @@ void World_Update(int ms)
     }
 }
 
+void World_Update(float dt)
+{
+    PROFILE_SCOPE("World_Update");
+    const auto start = std::chrono::steady_clock::now();
+    snapCameraInterpolation();
+
+    WorldInput ev;
+    while (g_SimInputs.Pop(ev)) {
+        applySimInput(ev);
+        ++g_InputsApplied;
+    }
+
+    stepSimulation(dt);
+
+    ++g_SimSteps;
+    g_SimBusyMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    publishWorldState();
+}
+
+static void simulationLoop()
+{
+    Profiler_SetThreadName("Simulación");
+
+    using Clock = std::chrono::steady_clock;
+    const auto step = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(SIM_STEP_S));
+    const auto maxLag = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(SIM_MAX_LAG_S));
+
+    Clock::time_point next = Clock::now();
+    while (g_SimRunning.load(std::memory_order_acquire)) {
+        World_Update(SIM_STEP_S);
+
+        next += step;
+        Clock::time_point now = Clock::now();
+        if (now - next > maxLag)
+            next = now;   // depurador, suspensión...: no meter segundos de física
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void World_StartSimulation()
+{
+    if (g_SimRunning.exchange(true))
+        return;
+    g_SimThread = std::thread(simulationLoop);
+}
+
+void World_StopSimulation()
+{
+    if (!g_SimRunning.exchange(false))
+        return;
+    g_SimThread.join();
+}
+
+// -----------------------------------------------------------------------------
+// Inicio de frame en el render: última instantánea y órdenes de la simulación
+// -----------------------------------------------------------------------------
+
+void World_BeginFrame()
+{
+    // Primero la instantánea: las órdenes emitidas antes de publicarla ya
+    // están en la cola al vaciarla justo después
+    g_View = g_Snapshots.Read();
+
+    // Pasos de simulación desde el frame anterior y su tiempo medio
+    static unsigned lastSimSteps = 0;
+    static double lastSimBusyMs = 0.0;
+    const unsigned steps = g_View.simSteps - lastSimSteps;
+    Profiler_SetCounter("World_Update (ms/paso)", steps ? (g_View.simBusyMs - lastSimBusyMs) / steps : 0.0);
+    Profiler_SetCounter("Pasos de simulación", steps);
+    lastSimSteps = g_View.simSteps;
+    lastSimBusyMs = g_View.simBusyMs;
+
+    WorldCommand cmd;
+    while (g_SimCommands.Pop(cmd)) {
+        switch (cmd.type) {
+        case WorldCommand::OPEN_PUZZLE:
+            Puzzles_OpenForPrism(cmd.arg);
+            g_PuzzleShown = Puzzles_IsOpen();
+            if (!g_PuzzleShown)
+                pushSimInput(WorldInput::PUZZLE_CLOSED);
+
+            // soltar ratón
+            mouseCaptured = false;
+            glutSetCursor(GLUT_CURSOR_LEFT_ARROW);
+            break;
+
+        case WorldCommand::START_LEVEL_LOAD:
+            StartAsyncLevelLoad((LevelDifficulty)cmd.arg);
+            g_PendingLevelUploaded = false;
+            break;
+
+        case WorldCommand::COMMIT_LEVEL:
+            // Cambiamos al nivel objetivo (MEDIUM o HARD)
+            CommitPendingLevel(*g_PendingLevel);
+            g_PendingLevel.reset();
+
+            // Volvemos a configurar la línea de SRX según el nuevo nivel
+            SetupSrxWelcomeForCurrentLevel();
+            pushSimInput(WorldInput::LEVEL_COMMITTED);
+            break;
+
+        case WorldCommand::LOAD_LEVEL_NOW:
+            g_CurrentLevel = (LevelDifficulty)cmd.arg;
+            LoadLevelData();
+
+            // En nivel medio no queremos texto del narrador SRX
+            if (g_CurrentLevel == LevelDifficulty::MEDIUM)
+                World_SetNarratorLine("", 0);
+            pushSimInput(WorldInput::LEVEL_COMMITTED);
+            break;
+        }
+    }
+
+    // Trozos del laberinto alrededor de la cámara (solo laberintos grandes)
+    updateStreaming(g_View.camX, g_View.camZ);
+
+    // El nivel objetivo se prepara en segundo plano; aquí solo se reparten
+    // las subidas a GL entre frames
+    if (g_PendingLevel && !g_PendingLevelUploaded && PumpAsyncLevelLoad()) {
+        g_PendingLevelUploaded = true;
+        pushSimInput(WorldInput::LEVEL_READY);
+    }
+
+    if (g_PuzzleShown && !Puzzles_IsOpen()) {
+        g_PuzzleShown = false;
+        pushSimInput(WorldInput::PUZZLE_CLOSED);
+    }
+}
+
 // -----------------------------------------------------------------------------
 // Render del mundo (llamado desde display en main.cpp)
 // -----------------------------------------------------------------------------
 
 void World_Render()
 {
+    PROFILE_SCOPE("World_Render");
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
 
+    // Con hilo de simulación el factor sale de la edad de la instantánea
+    float alpha = g_RenderAlpha;
+    if (g_SimRunning.load(std::memory_order_relaxed)) {
+        float age = std::chrono::duration<float>(std::chrono::steady_clock::now() - g_View.stepTime).count();
+        alpha = clampf(age / SIM_STEP_S, 0.0f, 1.0f);
+    }
+
+    const WorldState& v = g_View;
+    renderCamX = v.prevCamX + (v.camX - v.prevCamX) * alpha;
+    renderCamY = v.prevCamY + (v.camY - v.prevCamY) * alpha;
+    renderCamZ = v.prevCamZ + (v.camZ - v.prevCamZ) * alpha;
     setCamera();
 
+    if (g_PhaseTiming || Profiler_IsCapturing())
+        std::fill(g_PhaseMs, g_PhaseMs + RENDER_PHASE_COUNT, 0.0);
+
+    markPhase(RenderPhase::Sky);
     if (g_WorldStage < 4 && gHasSkyTexture) {
-        drawSkyEquirect(SKYDOME_RAD);
+        drawSkyBox(SKYBOX_HALF);
     }
 
     drawMaze();
+
+    markPhase(RenderPhase::Hud);
     drawCircleReticle(8.0f, 48);
 
     DrawLivesHUD();
@@ -2188,5 +4026,143 @@ void World_Render()
     DrawPauseOverlay();
 
     DrawScreenFade();
+    markPhase(RenderPhase::Count);
+}
+
+// Sin hilo de simulación: fracción del paso fijo transcurrida desde el
+// último World_Update (0..1)
+void World_SetRenderAlpha(float alpha)
+{
+    g_RenderAlpha = clampf(alpha, 0.0f, 1.0f);
+}
+
+// Pausa o puzzle sin transición en curso: la escena 3D no cambia sola y el
+// bucle principal puede dejar de redibujar hasta que llegue una entrada.
+bool World_IsIdle()
+{
+    // Eventos aún sin aplicar: la simulación puede cambiar de estado
+    if (g_View.inputsApplied != g_InputsPushed)
+        return false;
+    if (g_View.transition != TransitionState::NONE)
+        return false;
+    return g_View.paused || Puzzles_IsOpen();
+}
+
+// Ms hasta que el narrador necesite otro frame (siguiente letra, final de la
+// espera o paso del fundido); -1 si no hay línea en pantalla.
+int World_NextAnimationMs()
+{
+    if (g_SrxFullLine.empty())
+        return -1;
+    if (g_SrxStartMs == 0)
+        return 0;
+
+    static const int SRX_FADE_FRAME_MS = 33;
+
+    float elapsed = (glutGet(GLUT_ELAPSED_TIME) - g_SrxStartMs) / 1000.0f;
+    const float timeToType = g_SrxFullLine.size() / SRX_CHARS_PER_SEC;
+
+    float wait;
+    if (elapsed <= timeToType)
+        wait = (floorf(elapsed * SRX_CHARS_PER_SEC) + 1.0f) / SRX_CHARS_PER_SEC - elapsed;
+    else if (elapsed <= timeToType + SRX_HOLD_SEC)
+        wait = timeToType + SRX_HOLD_SEC - elapsed;
+    else
+        return SRX_FADE_FRAME_MS;
+
+    return std::max(1, (int)ceilf(wait * 1000.0f));
+}
+
+// -----------------------------------------------------------------------------
+// Ganchos para WorldBench
+// -----------------------------------------------------------------------------
+
+const char* RenderPhase_Name(RenderPhase phase)
+{
+    static const char* names[RENDER_PHASE_COUNT] = {
+        "sky", "floors", "walls", "prisms", "portal", "hud"
+    };
+    int i = (int)phase;
+    return (i >= 0 && i < RENDER_PHASE_COUNT) ? names[i] : "?";
+}
+
+void World_SetPhaseTiming(bool enabled, bool syncGL)
+{
+    g_PhaseTiming = enabled;
+    g_PhaseSyncGL = syncGL;
+    g_PhaseCurrent = -1;
+}
+
+void World_GetPhaseTimes(double outMs[RENDER_PHASE_COUNT])
+{
+    std::copy(g_PhaseMs, g_PhaseMs + RENDER_PHASE_COUNT, outMs);
+}
+
+void World_SetBenchmarkMode(bool enabled)
+{
+    g_BenchmarkMode = enabled;
+}
+
+void World_SetRectCoverMode(RectCoverMode mode)
+{
+    g_RectCoverMode = mode;
+}
+
+int World_GetWallRectCount()
+{
+    return (int)g_Level.wallRects.size();
+}
+
+void World_SetStreaming(int radiusChunks, size_t budgetBytes)
+{
+    g_StreamRadius = std::max(1, radiusChunks);
+    g_StreamBudgetBytes = budgetBytes;
+}
+
+void World_GetStreamStats(StreamStats& out)
+{
+    out = g_Stream.stats;
+}
+
+void World_LoadLevel(int level)
+{
+    g_CurrentLevel = (LevelDifficulty)std::clamp(level, 0, 2);
+    LoadLevelData();
+
+    camX = PLAYER_SPAWN_X;
+    camZ = PLAYER_SPAWN_Z;
+    camY = PLAYER_Y_EYE;
+    snapCameraInterpolation();
+    yaw = 0.0f;
+    pitch = 0.0f;
+    velY = 0.0f;
+
+    g_SimPrismActive.assign(greenPrisms.size(), true);
+    publishWorldState();
+}
+
+void World_SetCamera(float x, float y, float z, float yawRad, float pitchRad)
+{
+    camX = x;
+    camY = y;
+    camZ = z;
+    snapCameraInterpolation();
+    yaw = yawRad;
+    pitch = pitchRad;
+    publishWorldState();
+}
+
+void World_GetSpawn(float& x, float& z)
+{
+    x = PLAYER_SPAWN_X;
+    z = PLAYER_SPAWN_Z;
+}
+
+const BitGrid& World_GetMaze(int& width, int& height, float& cellSize)
+{
+    width = g_Level.mapW;
+    height = g_Level.mapH;
+    cellSize = CELL;
+    return g_Level.maze;
 }
 
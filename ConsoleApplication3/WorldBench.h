@@ -0,0 +1,68 @@
+// worldbench.h
+// Ganchos del mundo para el benchmark sin interacción (WorldBench): carga de
+// niveles, cámara guionizada y tiempos por fase de World_Render().
+
+#pragma once
+
+#include "BitGrid.h"
+#include "RectCover.h"
+
+#include <cstddef>
+#include <vector>
+
+// Fases de World_Render() en el orden en que se dibujan
+enum class RenderPhase { Sky, Floors, Walls, Prisms, Portal, Hud, Count };
+
+static const int RENDER_PHASE_COUNT = (int)RenderPhase::Count;
+
+const char* RenderPhase_Name(RenderPhase phase);
+
+// Con la medición activa cada fase acumula su tiempo de CPU. Con syncGL se
+// hace glFinish() en cada cambio de fase para que cuente también el trabajo
+// del driver (con Mesa llvmpipe, el rasterizado).
+void World_SetPhaseTiming(bool enabled, bool syncGL);
+
+// Tiempos del último World_Render() en ms, indexados por RenderPhase
+void World_GetPhaseTimes(double outMs[RENDER_PHASE_COUNT]);
+
+// Sin puzzles ni portal al tocar prismas o la sala final: la cámara
+// guionizada pasa por encima de todo sin cambiar de estado.
+void World_SetBenchmarkMode(bool enabled);
+
+// Descomposición de los muros en cajas; vale desde la siguiente carga de
+// nivel. También la usa el juego (--rects).
+void World_SetRectCoverMode(RectCoverMode mode);
+
+// Cajas de muro del laberinto activo (0 en un laberinto en streaming)
+int World_GetWallRectCount();
+
+// Streaming de laberintos grandes: los muros se hornean y cargan por trozos
+// de 32x32 celdas alrededor de la cámara. También lo usa el juego
+// (--stream-radius, --stream-budget-mb).
+struct StreamStats {
+    bool   active = false;      // el nivel activo va por trozos
+    int    radius = 0;          // radio efectivo en trozos (baja si no cabe)
+    int    residentChunks = 0;
+    int    queuedChunks = 0;    // pedidos al hilo de fondo o sin subir
+    size_t residentBytes = 0;   // malla + colisión de los residentes
+    int    loads = 0;           // desde que se activó el nivel
+    int    unloads = 0;
+    int    dropped = 0;         // horneados que llegaron cuando ya no hacían falta
+};
+
+// Radio (mínimo 1: los 3x3 trozos de la cámara) y presupuesto de memoria
+void World_SetStreaming(int radiusChunks, size_t budgetBytes);
+void World_GetStreamStats(StreamStats& out);
+
+// Estos ganchos tocan el estado de la simulación directamente: solo valen sin
+// hilo de simulación (World_StartSimulation), llamando a World_Update() y
+// World_BeginFrame() desde el mismo hilo que dibuja.
+
+// 0 = EASY, 1 = MEDIUM, 2 = HARD. Carga síncrona y cámara en el spawn.
+void World_LoadLevel(int level);
+
+void World_SetCamera(float x, float y, float z, float yawRad, float pitchRad);
+void World_GetSpawn(float& x, float& z);
+
+// Laberinto activo (bit a 1 = muro) y tamaño de celda en unidades
+const BitGrid& World_GetMaze(int& width, int& height, float& cellSize);
@@ -1,4 +1,13 @@
 // main.cpp
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
 #include <GL/glut.h>
 #include <GL/glu.h>
 
@@ -6,9 +15,31 @@
 #include "imgui_impl_glut.h"
 #include "imgui_impl_opengl2.h"
 
+#include "AssetPack.h"
+#include "Profiler.h"
+#include "RectCover.h"
+#include "TextureDiskCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <thread>
+
+#ifndef _WIN32
+#include <GL/glx.h>   // al final: las cabeceras de X11 definen macros como None
+#endif
+
 // ------------------- Mundo (world.cpp) -------------------
 extern void World_Init();
-extern void World_Update(int ms);
+extern void World_SetRectCoverMode(RectCoverMode mode);
+extern void World_SetStreaming(int radiusChunks, size_t budgetBytes);
+extern void World_StartSimulation();
+extern void World_StopSimulation();
+extern void World_BeginFrame();
 extern void World_Render();
 extern void World_OnResize(int w, int h);
 extern void World_OnKeyDown(unsigned char k, int x, int y);
@@ -16,22 +47,137 @@ extern void World_OnKeyUp(unsigned char k, int x, int y);
 extern void World_OnSpecialKey(int key, int x, int y);
 extern void World_OnMouseButton(int b, int s, int x, int y);
 extern void World_OnMouseMotion(int x, int y);
+extern bool World_IsIdle();
+extern int  World_NextAnimationMs();
 
 // ------------------- Puzzles (puzzles.cpp) -------------------
 extern void Puzzles_Init(int numPrisms);
 extern void Puzzles_DrawImGui();
 extern bool Puzzles_IsOpen();
+extern int  Puzzles_NextAnimationMs();
 
 // ---------------------------------------------------------
 // Tamaño inicial ventana
 // ---------------------------------------------------------
 int winW = 1600, winH = 900;
 
+// Ventana del perfilador (F4)
+static bool g_ShowProfiler = false;
+
+// ---------------------------------------------------------
+// Reloj de frame
+// ---------------------------------------------------------
+// La física avanza a paso fijo en su propio hilo (world.cpp); este hilo solo
+// dibuja, al ritmo del monitor (vsync) o limitado con --fps N, e interpola la
+// cámara entre los dos últimos pasos publicados.
+using FrameClock = std::chrono::steady_clock;
+
+static int g_RenderFpsCap = -1;                 // -1 = vsync, 0 = sin límite
+static FrameClock::time_point g_NextRenderTime;
+
+#ifndef _WIN32
+// ¿Está 'name' en la lista de extensiones GLX (separadas por espacios)?
+static bool hasGlxExtension(Display* dpy, const char* name)
+{
+    const char* list = glXQueryExtensionsString(dpy, DefaultScreen(dpy));
+    const size_t len = std::strlen(name);
+    for (const char* p = list; p && (p = std::strstr(p, name)) != nullptr; p += len)
+        if ((p == list || p[-1] == ' ') && (p[len] == ' ' || p[len] == '\0'))
+            return true;
+    return false;
+}
+#endif
+
+// Intervalo de intercambio de buffers: 1 = esperar al vsync, 0 = no esperar.
+// GL 1.1 no lo trae; es una extensión del sistema de ventanas que se carga con
+// el contexto ya creado. Sin ella se queda lo que elija el driver.
+static void setSwapInterval(int interval)
+{
+#ifdef _WIN32
+    typedef BOOL(WINAPI* SwapIntervalEXT)(int);
+    auto swapInterval = (SwapIntervalEXT)wglGetProcAddress("wglSwapIntervalEXT");
+    if (swapInterval && swapInterval(interval))
+        return;
+#else
+    Display* dpy = glXGetCurrentDisplay();
+    if (dpy && hasGlxExtension(dpy, "GLX_EXT_swap_control")) {
+        typedef void (*SwapIntervalEXT)(Display*, GLXDrawable, int);
+        auto swapInterval = (SwapIntervalEXT)glXGetProcAddress((const GLubyte*)"glXSwapIntervalEXT");
+        if (swapInterval) {
+            swapInterval(dpy, glXGetCurrentDrawable(), interval);
+            return;
+        }
+    }
+    if (dpy && hasGlxExtension(dpy, "GLX_MESA_swap_control")) {
+        typedef int (*SwapIntervalMESA)(unsigned);
+        auto swapInterval = (SwapIntervalMESA)glXGetProcAddress((const GLubyte*)"glXSwapIntervalMESA");
+        if (swapInterval && swapInterval((unsigned)interval) == 0)
+            return;
+    }
+#endif
+    std::cerr << "No se pudo fijar el intervalo de intercambio (vsync); se usa el del driver" << std::endl;
+}
+
+// ---------------------------------------------------------
+// Modo reposo (pausa o puzzle abierto)
+// ---------------------------------------------------------
+// Sin nada moviéndose se quita el idle de GLUT y el proceso queda dormido en
+// el bucle de eventos. Cada entrada pide unos frames más (ImGui necesita uno
+// o dos para asentar hover, popups y tamaños de ventana) y un temporizador
+// despierta al bucle cuando el narrador o el cierre del puzzle lo necesitan.
+static const int EVENT_REDRAW_FRAMES = 3;
+
+static bool g_Sleeping = false;
+static int  g_RedrawFrames = 0;      // frames pendientes en reposo
+static int  g_WakeGeneration = 0;    // invalida temporizadores viejos
+
+void idle();
+
+static void wakeUp()
+{
+    if (!g_Sleeping)
+        return;
+    g_Sleeping = false;
+    ++g_WakeGeneration;
+
+    g_NextRenderTime = FrameClock::now();
+    glutIdleFunc(idle);
+}
+
+static void requestRedraw()
+{
+    g_RedrawFrames = std::max(g_RedrawFrames, EVENT_REDRAW_FRAMES);
+    wakeUp();
+}
+
+static void wakeTimer(int generation)
+{
+    if (generation != g_WakeGeneration)
+        return;
+    g_RedrawFrames = std::max(g_RedrawFrames, 1);
+    wakeUp();
+}
+
+static void goToSleep()
+{
+    g_Sleeping = true;
+    ++g_WakeGeneration;
+    glutIdleFunc(nullptr);
+
+    int worldMs = World_NextAnimationMs();
+    int puzzleMs = Puzzles_NextAnimationMs();
+    int waitMs = worldMs < 0 ? puzzleMs : (puzzleMs < 0 ? worldMs : std::min(worldMs, puzzleMs));
+    if (waitMs >= 0)
+        glutTimerFunc((unsigned)waitMs, wakeTimer, g_WakeGeneration);
+}
+
 // ---------------------------------------------------------
 // display
 // ---------------------------------------------------------
 void display()
 {
+    World_BeginFrame();
+
     if (!Puzzles_IsOpen())
     {
         // Escena 3D normal
@@ -50,14 +196,32 @@ void display()
     ImGui::NewFrame();
 
     // Dibuja puzzle (si hay alguno abierto)
-    Puzzles_DrawImGui();
+    {
+        PROFILE_SCOPE("Puzzles_DrawImGui");
+        bool wasOpen = Puzzles_IsOpen();
+        Puzzles_DrawImGui();
+        if (wasOpen && !Puzzles_IsOpen())
+            PROFILE_EVENT("Puzzle cerrado");
+    }
 
-    ImGui::Render();
-    glDisable(GL_DEPTH_TEST);
-    ImGui_ImplOpenGL2_RenderDrawData(ImGui::GetDrawData());
-    glEnable(GL_DEPTH_TEST);
+    if (g_ShowProfiler)
+        Profiler_DrawImGui(&g_ShowProfiler);
+
+    {
+        PROFILE_SCOPE("ImGui render");
+        ImGui::Render();
+        ImDrawData* drawData = ImGui::GetDrawData();
+        for (int i = 0; i < drawData->CmdListsCount; ++i)
+            for (const ImDrawCmd& cmd : drawData->CmdLists[i]->CmdBuffer)
+                Profiler_CountDraw((int)cmd.ElemCount);
+
+        glDisable(GL_DEPTH_TEST);
+        ImGui_ImplOpenGL2_RenderDrawData(drawData);
+        glEnable(GL_DEPTH_TEST);
+    }
 
     glutSwapBuffers();
+    Profiler_EndFrame();
 }
 
 
@@ -66,6 +230,7 @@ void display()
 // ---------------------------------------------------------
 void reshape(int w, int h)
 {
+    requestRedraw();
     winW = w;
     winH = h;
     if (h == 0) h = 1;
@@ -78,15 +243,24 @@ void reshape(int w, int h)
 }
 
 // ---------------------------------------------------------
-// timer (llamado cada ~16 ms)
+// idle: pide un frame (la simulación va sola en su hilo)
 // ---------------------------------------------------------
-void timer(int ms)
+void idle()
 {
-    // Integra físicas / movimiento del mundo
-    World_Update(ms);
+    if (g_RenderFpsCap > 0) {
+        std::this_thread::sleep_until(g_NextRenderTime);
+        g_NextRenderTime = std::max(g_NextRenderTime + std::chrono::microseconds(1000000 / g_RenderFpsCap),
+            FrameClock::now());
+    }
 
+    if (World_IsIdle()) {
+        if (g_RedrawFrames == 0) {
+            goToSleep();
+            return;
+        }
+        --g_RedrawFrames;
+    }
     glutPostRedisplay();
-    glutTimerFunc(16, timer, 16);
 }
 
 // ---------------------------------------------------------
@@ -95,6 +269,8 @@ void timer(int ms)
 
 void keyboardDown(unsigned char k, int x, int y)
 {
+    requestRedraw();
+
     // Primero ImGui (por si quiere capturar teclas)
     ImGui_ImplGLUT_KeyboardFunc(k, x, y);
 
@@ -104,18 +280,38 @@ void keyboardDown(unsigned char k, int x, int y)
 
 void keyboardUp(unsigned char k, int x, int y)
 {
+    requestRedraw();
     ImGui_ImplGLUT_KeyboardUpFunc(k, x, y);
     World_OnKeyUp(k, x, y);
 }
 
 void specialKeys(int key, int x, int y)
 {
+    requestRedraw();
+
+    if (key == GLUT_KEY_F4)
+        g_ShowProfiler = !g_ShowProfiler;
+
+    // F5: empezar / terminar captura de traza (chrome://tracing o Perfetto)
+    if (key == GLUT_KEY_F5) {
+        if (Profiler_IsCapturing()) {
+            Profiler_StopCapture();
+        }
+        else {
+            char path[64];
+            std::snprintf(path, sizeof(path), "trace_%lld.json", (long long)std::time(nullptr));
+            Profiler_StartCapture(path);
+        }
+    }
+
     // F11, etc.
     World_OnSpecialKey(key, x, y);
 }
 
 void mouse(int b, int s, int x, int y)
 {
+    requestRedraw();
+
     // Primero alimentamos a ImGui con el evento de ratón normal
     ImGui_ImplGLUT_MouseFunc(b, s, x, y);
 
@@ -138,6 +334,8 @@ void mouse(int b, int s, int x, int y)
 
 void motion(int x, int y)
 {
+    requestRedraw();
+
     // Movimiento con botón pulsado (drag) → ImGui
     ImGui_ImplGLUT_MotionFunc(x, y);
 
@@ -148,6 +346,8 @@ void motion(int x, int y)
 
 void passiveMotion(int x, int y)
 {
+    requestRedraw();
+
     // Si quieres que el mundo también use passive motion:
     World_OnMouseMotion(x, y);
 }
@@ -158,9 +358,43 @@ void passiveMotion(int x, int y)
 int main(int argc, char** argv)
 {
     glutInit(&argc, argv);
+
+    // --fps N: limita el render a N frames por segundo sin vsync (0 = sin
+    //   límite); por defecto, al ritmo del monitor
+    // --rects minimum: partición mínima de los muros en cajas (ver RectCover.h)
+    // --stream-radius N, --stream-budget-mb M: trozos cargados alrededor de la
+    //   cámara y memoria máxima en laberintos grandes (por defecto 3 y 32)
+    // --texture-cache DIR|off: caché en disco de texturas (por defecto texcache)
+    // --pack FICHERO|off: paquete de assets (por defecto assets.pak si existe)
+    const char* packPath = "assets.pak";
+    int streamRadius = 3;
+    int streamBudgetMb = 32;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--fps") == 0)
+            g_RenderFpsCap = std::max(0, std::atoi(argv[i + 1]));
+        else if (std::strcmp(argv[i], "--rects") == 0 && std::strcmp(argv[i + 1], "minimum") == 0)
+            World_SetRectCoverMode(RectCoverMode::Minimum);
+        else if (std::strcmp(argv[i], "--stream-radius") == 0)
+            streamRadius = std::max(1, std::atoi(argv[i + 1]));
+        else if (std::strcmp(argv[i], "--stream-budget-mb") == 0)
+            streamBudgetMb = std::max(1, std::atoi(argv[i + 1]));
+        else if (std::strcmp(argv[i], "--texture-cache") == 0)
+            TextureDiskCache_SetDirectory(std::strcmp(argv[i + 1], "off") == 0 ? "" : argv[i + 1]);
+        else if (std::strcmp(argv[i], "--pack") == 0)
+            packPath = std::strcmp(argv[i + 1], "off") == 0 ? nullptr : argv[i + 1];
+    }
+    if (packPath)
+        AssetPack_Open(packPath);
+    World_SetStreaming(streamRadius, (size_t)streamBudgetMb << 20);
+
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
     glutInitWindowSize(winW, winH);
     glutCreateWindow("Laberinto con puzzles");
+    setSwapInterval(g_RenderFpsCap < 0 ? 1 : 0);
+
+    // Cerrar bien la traza si se sale en mitad de una captura
+    Profiler_SetThreadName("Principal");
+    std::atexit([] { Profiler_StopCapture(); });
 
     // Inicializa el mundo (OpenGL, texturas, laberinto, cámara…)
     World_Init();
@@ -185,7 +419,13 @@ int main(int argc, char** argv)
     glutMouseFunc(mouse);
     glutMotionFunc(motion);
     glutPassiveMotionFunc(passiveMotion);
-    glutTimerFunc(16, timer, 16);
+    glutIdleFunc(idle);
+
+    g_NextRenderTime = FrameClock::now();
+
+    // Física en su hilo desde aquí; se para antes de destruir el mundo
+    World_StartSimulation();
+    std::atexit([] { World_StopSimulation(); });
 
     glutMainLoop();
     return 0;
@@ -0,0 +1,55 @@
+// mazegenbench.cpp
+// Benchmark del generador procedural: tiempo de generación frente al tamaño
+// de la rejilla. Uso: MazeGenBench [repeticiones] [semilla]
+
+#include "MazeGen.h"
+#include "LevelFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    const int reps = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+    const unsigned seed = argc > 2 ? (unsigned)std::strtoul(argv[2], nullptr, 10) : 1234u;
+
+    static const int sizes[] = { 35, 65, 129, 257, 513, 1001, 2049, 4097 };
+
+    std::printf("%10s %12s %10s %10s %12s %8s\n",
+        "tamano", "celdas", "min ms", "media ms", "Mceldas/s", "abiertas");
+
+    for (int n : sizes) {
+        MazeGenParams params;
+        params.width = n;
+        params.height = n;
+        params.seed = seed;
+        params.numPrisms = 8;
+
+        double best = 1e30, total = 0.0;
+        int openCells = 0;
+
+        for (int r = 0; r < reps; ++r) {
+            LevelData level;
+            auto t0 = std::chrono::steady_clock::now();
+            bool ok = MazeGen_Generate(params, level);
+            auto t1 = std::chrono::steady_clock::now();
+            if (!ok) {
+                std::fprintf(stderr, "Fallo generando %dx%d\n", n, n);
+                return 1;
+            }
+
+            double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+            best = std::min(best, ms);
+            total += ms;
+            openCells = (int)((size_t)n * n - level.grid.Count());
+        }
+
+        const double cells = (double)n * n;
+        std::printf("%4dx%-5d %12.0f %10.2f %10.2f %12.1f %8d\n",
+            n, n, cells, best, total / reps, cells / (best * 1000.0), openCells);
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+// rectcoverbench.cpp
+// Benchmark de la descomposición de muros en cajas: número de rectángulos y
+// tiempo de construcción de greedy frente a la partición mínima, en los tres
+// niveles del juego y en laberintos generados.
+//
+// Uso (desde ConsoleApplication3, para encontrar levels/):
+//   RectCoverBench [repeticiones] [semilla]
+//
+// El tiempo de frame resultante se mide con WorldBench --rects greedy|minimum.
+
+#include "LevelFile.h"
+#include "MazeGen.h"
+#include "RectCover.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct CoverResult {
+    size_t rects = 0;
+    double bestMs = 0.0;
+};
+
+static CoverResult Measure(const LevelData& level, RectCoverMode mode, int reps)
+{
+    CoverResult r;
+    r.bestMs = 1e30;
+    std::vector<CellRect> rects;
+    for (int i = 0; i < reps; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        RectCover_Build(level.grid, mode, rects);
+        auto t1 = std::chrono::steady_clock::now();
+        r.bestMs = std::min(r.bestMs, std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    r.rects = rects.size();
+    return r;
+}
+
+static void PrintRow(const std::string& name, const LevelData& level, int reps)
+{
+    CoverResult g = Measure(level, RectCoverMode::Greedy, reps);
+    CoverResult m = Measure(level, RectCoverMode::Minimum, reps);
+    double saved = g.rects ? 100.0 * (double)(g.rects - m.rects) / g.rects : 0.0;
+    std::printf("%-12s %9dx%-6d %10zu %10zu %8.1f%% %10.3f %10.3f\n",
+        name.c_str(), level.width, level.height, g.rects, m.rects, saved, g.bestMs, m.bestMs);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int reps = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+    const unsigned seed = argc > 2 ? (unsigned)std::strtoul(argv[2], nullptr, 10) : 1234u;
+
+    std::printf("%-12s %16s %10s %10s %9s %10s %10s\n",
+        "laberinto", "tamano", "greedy", "minimo", "ahorro", "greedy ms", "minimo ms");
+
+    static const char* levels[] = { "easy", "medium", "hard" };
+    for (const char* name : levels) {
+        LevelData level;
+        std::string path = std::string("levels/") + name + ".lvl";
+        if (!LevelFile_Load(path.c_str(), level)) {
+            std::fprintf(stderr, "No se pudo cargar %s\n", path.c_str());
+            continue;
+        }
+        PrintRow(name, level, reps);
+    }
+
+    static const int sizes[] = { 35, 65, 129, 257, 513, 1001, 2049 };
+    for (int n : sizes) {
+        MazeGenParams params;
+        params.width = n;
+        params.height = n;
+        params.seed = seed;
+
+        LevelData level;
+        if (!MazeGen_Generate(params, level)) {
+            std::fprintf(stderr, "Fallo generando %dx%d\n", n, n);
+            return 1;
+        }
+        PrintRow("generado", level, reps);
+    }
+    return 0;
+}
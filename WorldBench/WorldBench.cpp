@@ -0,0 +1,346 @@
+// worldbench.cpp
+// Benchmark sin interacción del mundo: carga EASY/MEDIUM/HARD, recorre cada
+// laberinto con una cámara guionizada (spawn -> entrada -> camino solución ->
+// sala final) y mide por frame World_Update() y World_Render(), este último
+// desglosado por fases. Escribe <salida>.csv (un frame por fila) y
+// <salida>.json (media y percentiles por nivel).
+//
+// Uso: WorldBench [--rects greedy|minimum] [frames_max] [salida] [ancho alto]
+//   --rects    = descomposición de los muros en cajas (por defecto greedy)
+//   frames_max = 0 recorre el camino completo (por defecto)
+//   salida     = prefijo de los ficheros (por defecto "worldbench")
+//
+// Para comparar el tiempo de frame de ambas descomposiciones se lanza dos
+// veces con salidas distintas; RectCoverBench compara cajas y tiempo de
+// construcción.
+//
+// En Linux sin GPU, con Mesa llvmpipe bajo un framebuffer virtual (desde la
+// raíz del repositorio):
+//   g++ -std=c++17 -O2 -IConsoleApplication3 -o WorldBench
+//       WorldBench/WorldBench.cpp $(ls ConsoleApplication3/*.cpp | grep -v main.cpp)
+//       -lglut -lGLU -lGL -lpthread
+//   cd ConsoleApplication3
+//   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -s "-screen 0 1280x720x24" ../WorldBench 0 ../worldbench
+
+#include <GL/freeglut.h>
+
+#include "AssetPack.h"
+#include "WorldBench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <string>
+#include <vector>
+
+extern void World_Init();
+extern void World_Update(float dt);
+extern void World_BeginFrame();
+extern void World_Render();
+extern void World_OnResize(int w, int h);
+
+namespace {
+
+static const int   FRAME_MS = 16;          // un frame a 60 Hz por muestra
+static const int   WARMUP_FRAMES = 30;     // no se registran
+static const float CAMERA_SPEED = 3.0f;    // unidades/s (velocidad de paseo)
+static const float LOOK_AHEAD = 1.5f;      // la cámara mira este tramo por delante
+static const float EYE_Y = 1.62f;
+
+static const char* LEVEL_NAMES[3] = { "easy", "medium", "hard" };
+
+struct Point { float x, z; };
+
+// Métricas por frame: update, render y una por fase
+static const int METRIC_COUNT = 2 + RENDER_PHASE_COUNT;
+
+static const char* MetricName(int m)
+{
+    if (m == 0) return "update_ms";
+    if (m == 1) return "render_ms";
+    static std::string names[RENDER_PHASE_COUNT];
+    std::string& n = names[m - 2];
+    if (n.empty())
+        n = std::string(RenderPhase_Name((RenderPhase)(m - 2))) + "_ms";
+    return n.c_str();
+}
+
+// Celda abierta de la fila 'z' más cercana a la columna central
+static int OpenCellNearCenter(const BitGrid& maze, int w, int z)
+{
+    for (int d = 0; d <= w / 2; ++d) {
+        for (int x : { w / 2 - d, w / 2 + d })
+            if (x >= 0 && x < w && !maze.Get(x, z))
+                return x;
+    }
+    return -1;
+}
+
+// Camino solución por BFS entre la entrada (fila 0) y la salida (última
+// fila), en centros de celda. Vacío si no hay camino.
+static std::vector<Point> SolutionPath(const BitGrid& maze, int w, int h, float cell)
+{
+    std::vector<Point> path;
+    const int x0 = OpenCellNearCenter(maze, w, 0);
+    const int x1 = OpenCellNearCenter(maze, w, h - 1);
+    if (x0 < 0 || x1 < 0)
+        return path;
+
+    const int start = x0, goal = (h - 1) * w + x1;
+    std::vector<int> prev((size_t)w * h, -1);
+    std::queue<int> open;
+    prev[start] = start;
+    open.push(start);
+
+    while (!open.empty() && prev[goal] < 0) {
+        int c = open.front();
+        open.pop();
+        int cx = c % w, cz = c / w;
+        const int nx[4] = { cx + 1, cx - 1, cx, cx };
+        const int nz[4] = { cz, cz, cz + 1, cz - 1 };
+        for (int k = 0; k < 4; ++k) {
+            if (nx[k] < 0 || nx[k] >= w || nz[k] < 0 || nz[k] >= h) continue;
+            int n = nz[k] * w + nx[k];
+            if (maze.Get(nx[k], nz[k]) || prev[n] >= 0) continue;
+            prev[n] = c;
+            open.push(n);
+        }
+    }
+    if (prev[goal] < 0)
+        return path;
+
+    for (int c = goal; ; c = prev[c]) {
+        path.push_back({ (c % w + 0.5f) * cell, (c / w + 0.5f) * cell });
+        if (c == start) break;
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+// Recorrido completo: foyer, pasillo, laberinto y sala final
+static std::vector<Point> CameraPath()
+{
+    int w, h;
+    float cell;
+    const BitGrid& maze = World_GetMaze(w, h, cell);
+
+    std::vector<Point> path;
+    float sx, sz;
+    World_GetSpawn(sx, sz);
+    path.push_back({ sx, sz });
+
+    std::vector<Point> solution = SolutionPath(maze, w, h, cell);
+    if (solution.empty()) {
+        std::fprintf(stderr, "Sin camino entre entrada y salida; solo se recorre el foyer\n");
+        path.push_back({ sx, 0.0f });
+        return path;
+    }
+
+    path.push_back({ solution.front().x, -cell });   // pasillo hacia la entrada
+    path.insert(path.end(), solution.begin(), solution.end());
+    path.push_back({ solution.back().x, (h + 1.0f) * cell });   // sala final
+    return path;
+}
+
+// Punto a distancia 'd' del inicio del camino (recortado al final)
+static Point PointAt(const std::vector<Point>& path, const std::vector<float>& dist, float d)
+{
+    if (d <= 0.0f) return path.front();
+    if (d >= dist.back()) return path.back();
+    size_t i = std::upper_bound(dist.begin(), dist.end(), d) - dist.begin();
+    float seg = dist[i] - dist[i - 1];
+    float t = seg > 0.0f ? (d - dist[i - 1]) / seg : 0.0f;
+    return { path[i - 1].x + (path[i].x - path[i - 1].x) * t,
+             path[i - 1].z + (path[i].z - path[i - 1].z) * t };
+}
+
+static double Percentile(std::vector<double> v, double p)
+{
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    size_t rank = (size_t)std::ceil(p / 100.0 * v.size());
+    return v[std::clamp<size_t>(rank, 1, v.size()) - 1];
+}
+
+struct LevelRun {
+    const char* name = "";
+    int wallRects = 0;
+    std::vector<double> samples[METRIC_COUNT];
+};
+
+static double Now()
+{
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static LevelRun RunLevel(int level, int maxFrames)
+{
+    LevelRun run;
+    run.name = LEVEL_NAMES[level];
+
+    World_LoadLevel(level);
+    run.wallRects = World_GetWallRectCount();
+
+    std::vector<Point> path = CameraPath();
+    std::vector<float> dist(path.size(), 0.0f);
+    for (size_t i = 1; i < path.size(); ++i)
+        dist[i] = dist[i - 1] + std::hypot(path[i].x - path[i - 1].x, path[i].z - path[i - 1].z);
+
+    const float step = CAMERA_SPEED * FRAME_MS / 1000.0f;
+    int frames = (int)std::ceil(dist.back() / step) + 1;
+    if (maxFrames > 0)
+        frames = std::min(frames, maxFrames);
+
+    for (int f = -WARMUP_FRAMES; f < frames; ++f) {
+        float d = std::max(0, f) * step;
+        Point p = PointAt(path, dist, d);
+        Point ahead = PointAt(path, dist, d + LOOK_AHEAD);
+        float yaw = std::atan2(ahead.z - p.z, ahead.x - p.x);
+
+        World_SetCamera(p.x, EYE_Y, p.z, yaw, 0.0f);
+
+        double t0 = Now();
+        World_Update(FRAME_MS / 1000.0f);
+        double t1 = Now();
+        World_BeginFrame();
+        World_Render();
+        glFinish();
+        double t2 = Now();
+
+        glutSwapBuffers();
+        glutMainLoopEvent();
+
+        if (f < 0)
+            continue;
+
+        double phases[RENDER_PHASE_COUNT];
+        World_GetPhaseTimes(phases);
+        run.samples[0].push_back(t1 - t0);
+        run.samples[1].push_back(t2 - t1);
+        for (int i = 0; i < RENDER_PHASE_COUNT; ++i)
+            run.samples[2 + i].push_back(phases[i]);
+    }
+    return run;
+}
+
+static bool WriteCsv(const std::string& path, const std::vector<LevelRun>& runs)
+{
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+
+    std::fprintf(f, "level,frame");
+    for (int m = 0; m < METRIC_COUNT; ++m)
+        std::fprintf(f, ",%s", MetricName(m));
+    std::fprintf(f, "\n");
+
+    for (const LevelRun& run : runs) {
+        for (size_t i = 0; i < run.samples[0].size(); ++i) {
+            std::fprintf(f, "%s,%zu", run.name, i);
+            for (int m = 0; m < METRIC_COUNT; ++m)
+                std::fprintf(f, ",%.4f", run.samples[m][i]);
+            std::fprintf(f, "\n");
+        }
+    }
+    std::fclose(f);
+    return true;
+}
+
+static bool WriteJson(const std::string& path, const std::vector<LevelRun>& runs,
+    int width, int height, const char* renderer, const char* rectCover)
+{
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+
+    std::fprintf(f, "{\n  \"width\": %d,\n  \"height\": %d,\n  \"frame_ms\": %d,\n"
+        "  \"renderer\": \"%s\",\n  \"rect_cover\": \"%s\",\n  \"levels\": [\n",
+        width, height, FRAME_MS, renderer, rectCover);
+
+    for (size_t r = 0; r < runs.size(); ++r) {
+        const LevelRun& run = runs[r];
+        std::fprintf(f, "    {\n      \"name\": \"%s\",\n      \"frames\": %zu,\n"
+            "      \"wall_rects\": %d,\n      \"metrics\": {\n",
+            run.name, run.samples[0].size(), run.wallRects);
+        for (int m = 0; m < METRIC_COUNT; ++m) {
+            const std::vector<double>& v = run.samples[m];
+            double mean = 0.0;
+            for (double x : v) mean += x;
+            if (!v.empty()) mean /= v.size();
+            std::fprintf(f, "        \"%s\": { \"mean\": %.4f, \"p50\": %.4f, \"p90\": %.4f, "
+                "\"p99\": %.4f, \"max\": %.4f }%s\n",
+                MetricName(m), mean, Percentile(v, 50), Percentile(v, 90),
+                Percentile(v, 99), Percentile(v, 100), m + 1 < METRIC_COUNT ? "," : "");
+        }
+        std::fprintf(f, "      }\n    }%s\n", r + 1 < runs.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+    std::fclose(f);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    glutInit(&argc, argv);
+
+    // --rects se quita de argv para no mover los argumentos posicionales
+    RectCoverMode rectMode = RectCoverMode::Greedy;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--rects") != 0)
+            continue;
+        if (std::strcmp(argv[i + 1], "minimum") == 0)
+            rectMode = RectCoverMode::Minimum;
+        std::copy(argv + i + 2, argv + argc, argv + i);
+        argc -= 2;
+        break;
+    }
+
+    const int maxFrames = argc > 1 ? std::max(0, std::atoi(argv[1])) : 0;
+    const std::string out = argc > 2 ? argv[2] : "worldbench";
+    const int width = argc > 4 ? std::max(64, std::atoi(argv[3])) : 1280;
+    const int height = argc > 4 ? std::max(64, std::atoi(argv[4])) : 720;
+
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
+    glutInitWindowSize(width, height);
+    glutCreateWindow("WorldBench");
+
+    // Mismos assets que el juego: del paquete si existe
+    AssetPack_Open("assets.pak");
+    World_SetRectCoverMode(rectMode);
+    World_Init();
+    World_OnResize(width, height);
+    World_SetBenchmarkMode(true);
+    World_SetPhaseTiming(true, true);
+
+    const char* renderer = (const char*)glGetString(GL_RENDERER);
+    if (!renderer) renderer = "?";
+    std::printf("GL_RENDERER: %s\nrect_cover: %s\n", renderer, RectCover_Name(rectMode));
+
+    std::vector<LevelRun> runs;
+    for (int level = 0; level < 3; ++level)
+        runs.push_back(RunLevel(level, maxFrames));
+
+    std::printf("%-8s %-12s %8s %8s %8s %8s\n", "nivel", "metrica", "media", "p50", "p90", "p99");
+    for (const LevelRun& run : runs) {
+        for (int m = 0; m < METRIC_COUNT; ++m) {
+            const std::vector<double>& v = run.samples[m];
+            double mean = 0.0;
+            for (double x : v) mean += x;
+            if (!v.empty()) mean /= v.size();
+            std::printf("%-8s %-12s %8.3f %8.3f %8.3f %8.3f\n", run.name, MetricName(m),
+                mean, Percentile(v, 50), Percentile(v, 90), Percentile(v, 99));
+        }
+    }
+
+    if (!WriteCsv(out + ".csv", runs) || !WriteJson(out + ".json", runs, width, height, renderer, RectCover_Name(rectMode))) {
+        std::fprintf(stderr, "No se pudo escribir %s.csv / %s.json\n", out.c_str(), out.c_str());
+        return 1;
+    }
+    std::printf("Escrito %s.csv y %s.json\n", out.c_str(), out.c_str());
+    return 0;
+}